@@ -18,13 +18,17 @@
 #include "vast/detail/narrow.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/error.hpp"
+#include "vast/ids.hpp"
 #include "vast/logger.hpp"
+#include "vast/operator.hpp"
 #include "vast/value_index.hpp"
 
 #include <caf/binary_deserializer.hpp>
 #include <caf/binary_serializer.hpp>
 #include <caf/detail/type_list.hpp>
 
+#include <algorithm>
+
 #include <arrow/io/api.h>
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
@@ -654,6 +658,212 @@ private:
   value_index& idx_;
 };
 
+// -- evaluation of an entire column -------------------------------------------
+
+/// Evaluates a predicate over an entire column. Comparisons with a value of
+/// the column type and substring searches run in tight loops over the Arrow
+/// arrays; all other predicates fall back to `evaluate_view`.
+class column_evaluator {
+public:
+  column_evaluator(const type& t, relational_operator op, const data& rhs,
+                   ids& result)
+    : type_{t},
+      op_{op},
+      rhs_{rhs},
+      rhs_view_{make_data_view(rhs)},
+      null_result_{evaluate_view(caf::none, op, rhs_view_)},
+      result_{result} {
+    // nop
+  }
+
+  void operator()(const arrow::BooleanArray& arr, const bool_type&) {
+    if (!compare<bool>(arr, boolean_at))
+      apply(arr, boolean_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const real_type&) {
+    if (!compare<real>(arr, real_at))
+      apply(arr, real_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const integer_type&) {
+    if (!compare<integer>(arr, integer_at))
+      apply(arr, integer_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const count_type&) {
+    if (!compare<count>(arr, count_at))
+      apply(arr, count_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const enumeration_type&) {
+    apply(arr, enumeration_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::NumericArray<T>& arr, const duration_type&) {
+    if (!compare<duration>(arr, duration_at))
+      apply(arr, duration_at);
+  }
+
+  void operator()(const arrow::FixedSizeBinaryArray& arr, const address_type&) {
+    if (!compare<address>(arr, address_at) && !contained(arr))
+      apply(arr, address_at);
+  }
+
+  void operator()(const arrow::FixedSizeBinaryArray& arr, const subnet_type&) {
+    apply(arr, subnet_at);
+  }
+
+  void operator()(const arrow::FixedSizeBinaryArray& arr, const port_type&) {
+    apply(arr, port_at);
+  }
+
+  void operator()(const arrow::StringArray& arr, const string_type&) {
+    if (!compare<std::string>(arr, string_at) && !search(arr))
+      apply(arr, string_at);
+  }
+
+  void operator()(const arrow::StringArray& arr, const pattern_type&) {
+    apply(arr, pattern_at);
+  }
+
+  void operator()(const arrow::TimestampArray& arr, const time_type&) {
+    if (!compare<time>(arr, timestamp_at))
+      apply(arr, timestamp_at);
+  }
+
+  template <class T>
+  void operator()(const arrow::ListArray& arr, const T& t) {
+    if constexpr (std::is_same_v<T, list_type>) {
+      auto f = [&](const auto& arr, int64_t row) {
+        return list_at(t.value_type, arr, row);
+      };
+      apply(arr, f);
+    } else {
+      static_assert(std::is_same_v<T, map_type>);
+      auto f = [&](const auto& arr, int64_t row) {
+        return map_at(t.key_type, t.value_type, arr, row);
+      };
+      apply(arr, f);
+    }
+  }
+
+private:
+  /// Appends `p(row)` for every row, or the result for nil if the row is
+  /// null, 64 bits at a time.
+  template <class Array, class Predicate>
+  void each(const Array& arr, Predicate p) {
+    constexpr auto width = int64_t{ids::word_type::width};
+    auto has_nulls = arr.null_count() > 0;
+    for (int64_t first = 0; first < arr.length(); first += width) {
+      auto n = std::min(width, arr.length() - first);
+      auto block = ids::block_type{0};
+      if (has_nulls) {
+        for (int64_t i = 0; i < n; ++i) {
+          auto bit = arr.IsNull(first + i) ? null_result_ : p(first + i);
+          block |= static_cast<ids::block_type>(bit) << i;
+        }
+      } else {
+        for (int64_t i = 0; i < n; ++i)
+          block |= static_cast<ids::block_type>(p(first + i)) << i;
+      }
+      result_.append_block(block, detail::narrow_cast<size_t>(n));
+    }
+  }
+
+  template <class Array, class Getter>
+  void apply(const Array& arr, Getter f) {
+    each(arr, [&](int64_t row) {
+      data_view x = f(arr, row);
+      return evaluate_view(to_canonical(type_, x), op_, rhs_view_);
+    });
+  }
+
+  /// Handles comparisons with a RHS of type `T`.
+  template <class T, class Array, class Getter>
+  bool compare(const Array& arr, Getter f) {
+    auto y = caf::get_if<T>(&rhs_);
+    if (!y)
+      return false;
+    auto& x = *y;
+    switch (op_) {
+      default:
+        return false;
+      case equal:
+        each(arr, [&](int64_t row) { return f(arr, row) == x; });
+        return true;
+      case not_equal:
+        each(arr, [&](int64_t row) { return f(arr, row) != x; });
+        return true;
+      case less:
+        each(arr, [&](int64_t row) { return f(arr, row) < x; });
+        return true;
+      case less_equal:
+        each(arr, [&](int64_t row) { return f(arr, row) <= x; });
+        return true;
+      case greater:
+        each(arr, [&](int64_t row) { return f(arr, row) > x; });
+        return true;
+      case greater_equal:
+        each(arr, [&](int64_t row) { return f(arr, row) >= x; });
+        return true;
+    }
+  }
+
+  /// Handles membership of addresses in a subnet.
+  bool contained(const arrow::FixedSizeBinaryArray& arr) {
+    auto y = caf::get_if<subnet>(&rhs_);
+    if (!y || (op_ != in && op_ != not_in))
+      return false;
+    auto negate = op_ == not_in;
+    each(arr, [&](int64_t row) {
+      return y->contains(address_at(arr, row)) != negate;
+    });
+    return true;
+  }
+
+  /// Handles substring searches.
+  bool search(const arrow::StringArray& arr) {
+    auto y = caf::get_if<std::string>(&rhs_);
+    if (!y)
+      return false;
+    auto needle = std::string_view{*y};
+    auto npos = std::string_view::npos;
+    switch (op_) {
+      default:
+        return false;
+      case in:
+      case not_in: {
+        auto negate = op_ == not_in;
+        each(arr, [&](int64_t row) {
+          return (needle.find(string_at(arr, row)) != npos) != negate;
+        });
+        return true;
+      }
+      case ni:
+      case not_ni: {
+        auto negate = op_ == not_ni;
+        each(arr, [&](int64_t row) {
+          return (string_at(arr, row).find(needle) != npos) != negate;
+        });
+        return true;
+      }
+    }
+  }
+
+  const type& type_;
+  relational_operator op_;
+  const data& rhs_;
+  data_view rhs_view_;
+  bool null_result_;
+  ids& result_;
+};
+
 } // namespace
 
 // -- remaining implementation of arrow_table_slice ----------------------------
@@ -672,4 +882,17 @@ void arrow_table_slice::append_column_to_index(size_type col,
   decode(layout().fields[col].type, *arr, f);
 }
 
+void arrow_table_slice::evaluate_column(size_type col, relational_operator op,
+                                        const data& rhs, ids& result) const {
+  auto& t = layout().fields[col].type;
+  ids column;
+  column_evaluator f{t, op, rhs, column};
+  auto arr = batch_->column(detail::narrow_cast<int>(col));
+  decode(t, *arr, f);
+  // Decoding skips arrays that do not match the type of the column.
+  if (column.size() != rows())
+    return super::evaluate_column(col, op, rhs, result);
+  result.append(column);
+}
+
 } // namespace vast
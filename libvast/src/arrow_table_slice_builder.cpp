@@ -14,6 +14,7 @@
 #include "vast/arrow_table_slice_builder.hpp"
 
 #include "vast/arrow_table_slice.hpp"
+#include "vast/detail/assert.hpp"
 #include "vast/detail/byte_swap.hpp"
 #include "vast/detail/narrow.hpp"
 #include "vast/detail/overload.hpp"
@@ -417,6 +418,55 @@ private:
   column_builder_ptr val_builder_;
 };
 
+// Reserves the memory for appending a column, such that the subsequent
+// append cannot fail.
+template <class Builder, class T>
+bool reserve(arrow::ArrayBuilder& builder, const table_slice_builder::column&,
+             span<const T> ys) {
+  auto& b = static_cast<Builder&>(builder);
+  return b.Reserve(detail::narrow_cast<int64_t>(ys.size())).ok();
+}
+
+// Reserves the memory for the offsets and the characters of a string column.
+bool reserve_strings(arrow::ArrayBuilder& builder,
+                     const table_slice_builder::column& x,
+                     span<const std::string_view> ys) {
+  auto& b = static_cast<arrow::StringBuilder&>(builder);
+  int64_t bytes = 0;
+  for (size_t row = 0; row < ys.size(); ++row)
+    if (!x.is_nil(row))
+      bytes += detail::narrow_cast<int64_t>(ys[row].size());
+  return b.Reserve(detail::narrow_cast<int64_t>(ys.size())).ok()
+         && b.ReserveData(bytes).ok();
+}
+
+// Appends a column of fixed-width values with a single bulk copy.
+// @pre The builder reserved memory for the column.
+template <class Builder, class T>
+void append_values(arrow::ArrayBuilder& builder,
+                   const table_slice_builder::column& x, span<const T> ys) {
+  auto& b = static_cast<Builder&>(builder);
+  auto valid = x.valid.empty() ? nullptr : x.valid.data();
+  auto n = detail::narrow_cast<int64_t>(ys.size());
+  [[maybe_unused]] auto status = b.AppendValues(ys.data(), n, valid);
+  VAST_ASSERT(status.ok());
+}
+
+// Appends a column value by value for types without a bulk append, which
+// still bypasses the data_view round-trip of `add`.
+// @pre The builder reserved memory for the column.
+template <class Builder, class T, class F>
+void append_each(arrow::ArrayBuilder& builder,
+                 const table_slice_builder::column& x, span<const T> ys, F f) {
+  auto& b = static_cast<Builder&>(builder);
+  for (size_t row = 0; row < ys.size(); ++row) {
+    if (x.is_nil(row))
+      b.UnsafeAppendNull();
+    else
+      f(b, ys[row]);
+  }
+}
+
 } // namespace
 
 // -- table slice builder implementation ---------------------------------------
@@ -530,6 +580,59 @@ bool arrow_table_slice_builder::add_impl(data_view x) {
   return true;
 }
 
+bool arrow_table_slice_builder::add_columns_impl(const std::vector<column>& xs,
+                                                 size_t rows) {
+  if (col_ != 0)
+    return false;
+  // Reserve the memory for all columns before appending the first one. Arrow
+  // builders cannot drop appended values, so a failure halfway through would
+  // leave the columns with different lengths.
+  for (size_t i = 0; i < xs.size(); ++i) {
+    auto& x = xs[i];
+    auto& builder = *builders_[i]->arrow_builder();
+    auto f = detail::overload(
+      [&](span<const integer> ys) {
+        return reserve<arrow::Int64Builder>(builder, x, ys);
+      },
+      [&](span<const count> ys) {
+        return reserve<arrow::UInt64Builder>(builder, x, ys);
+      },
+      [&](span<const std::string_view> ys) {
+        return reserve_strings(builder, x, ys);
+      },
+      [&](span<const address> ys) {
+        return reserve<arrow::FixedSizeBinaryBuilder>(builder, x, ys);
+      });
+    if (!caf::visit(f, x.values))
+      return false;
+  }
+  for (size_t i = 0; i < xs.size(); ++i) {
+    auto& x = xs[i];
+    auto& builder = *builders_[i]->arrow_builder();
+    auto f = detail::overload(
+      [&](span<const integer> ys) {
+        append_values<arrow::Int64Builder>(builder, x, ys);
+      },
+      [&](span<const count> ys) {
+        append_values<arrow::UInt64Builder>(builder, x, ys);
+      },
+      [&](span<const std::string_view> ys) {
+        append_each<arrow::StringBuilder>(
+          builder, x, ys, [](auto& b, std::string_view y) {
+            b.UnsafeAppend(arrow::util::string_view(y.data(), y.size()));
+          });
+      },
+      [&](span<const address> ys) {
+        append_each<arrow::FixedSizeBinaryBuilder>(
+          builder, x, ys,
+          [](auto& b, const address& y) { b.UnsafeAppend(y.data().data()); });
+      });
+    caf::visit(f, x.values);
+  }
+  rows_ += rows;
+  return true;
+}
+
 table_slice_ptr arrow_table_slice_builder::finish() {
   // Sanity check.
   if (col_ != 0)
@@ -0,0 +1,181 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/candidate_checker.hpp"
+
+#include "vast/bitmap_algorithms.hpp"
+#include "vast/detail/assert.hpp"
+#include "vast/die.hpp"
+#include "vast/expression.hpp"
+#include "vast/logger.hpp"
+#include "vast/table_slice.hpp"
+
+namespace vast {
+
+struct candidate_checker::compiler {
+  using opcode = instruction::opcode;
+
+  template <class T>
+  void operator()(const data& d, const T& x) {
+    (*this)(x, d);
+  }
+
+  template <class T, class U>
+  void operator()(const T&, const U&) {
+    constant(false);
+  }
+
+  void operator()(caf::none_t) {
+    constant(false);
+  }
+
+  void operator()(const conjunction& c) {
+    auto i = open(opcode::conjunction);
+    for (auto& op : c)
+      caf::visit(*this, op);
+    close(i);
+  }
+
+  void operator()(const disjunction& d) {
+    auto i = open(opcode::disjunction);
+    for (auto& op : d)
+      caf::visit(*this, op);
+    close(i);
+  }
+
+  void operator()(const negation& n) {
+    auto i = open(opcode::negation);
+    caf::visit(*this, n.expr());
+    close(i);
+  }
+
+  void operator()(const predicate& p) {
+    op = p.op;
+    caf::visit(*this, p.lhs, p.rhs);
+  }
+
+  void operator()(const attribute_extractor& e, const data& d) {
+    if (e.attr == atom::type_v)
+      return constant(evaluate(layout.name(), op, d));
+    if (e.attr == atom::timestamp_v) {
+      // The event timestamp is the first column.
+      if (layout.fields.empty())
+        return constant(false);
+      auto& field = layout.fields[0];
+      if (has_attribute(field.type, "timestamp")
+          && !caf::holds_alternative<time_type>(field.type)) {
+        VAST_WARNING_ANON("got timestamp attribute for non-time type");
+        return constant(false);
+      }
+      return column(0, d);
+    }
+    constant(false);
+  }
+
+  void operator()(const type_extractor&, const data&) {
+    die("type extractor should have been resolved at this point");
+  }
+
+  void operator()(const field_extractor&, const data&) {
+    die("field extractor should have been resolved at this point");
+  }
+
+  void operator()(const data_extractor& e, const data& d) {
+    VAST_ASSERT(e.offset.size() == 1);
+    if (e.type != layout) // TODO: make this a precondition instead.
+      return constant(false);
+    column(e.offset[0], d);
+  }
+
+  void constant(bool value) {
+    auto& x = program.emplace_back();
+    x.code = opcode::constant;
+    x.value = value;
+  }
+
+  void column(size_t col, const data& d) {
+    auto& x = program.emplace_back();
+    x.code = opcode::column;
+    x.op = op;
+    x.column = col;
+    x.rhs = d;
+  }
+
+  size_t open(opcode code) {
+    program.emplace_back().code = code;
+    return program.size() - 1;
+  }
+
+  void close(size_t i) {
+    program[i].size = program.size() - i;
+  }
+
+  std::vector<instruction>& program;
+  const record_type& layout;
+  relational_operator op = equal;
+};
+
+candidate_checker::candidate_checker(const expression& expr,
+                                     const record_type& layout) {
+  caf::visit(compiler{program_, layout}, expr);
+}
+
+ids candidate_checker::operator()(const table_slice& slice) const {
+  VAST_ASSERT(!program_.empty());
+  ids result;
+  result.append(false, slice.offset());
+  size_t pc = 0;
+  result.append(run(slice, pc));
+  return result;
+}
+
+ids candidate_checker::run(const table_slice& slice, size_t& pc) const {
+  using opcode = instruction::opcode;
+  auto& x = program_[pc++];
+  auto last = pc - 1 + x.size;
+  switch (x.code) {
+    case opcode::constant:
+      return ids{slice.rows(), x.value};
+    case opcode::column: {
+      ids result;
+      slice.evaluate_column(x.column, x.op, x.rhs, result);
+      VAST_ASSERT(result.size() == slice.rows());
+      return result;
+    }
+    case opcode::conjunction: {
+      auto result = ids{slice.rows(), true};
+      while (pc != last) {
+        result &= run(slice, pc);
+        // No need to look at the remaining operands once no row can match.
+        if (!any<1>(result))
+          pc = last;
+      }
+      return result;
+    }
+    case opcode::disjunction: {
+      auto result = ids{slice.rows(), false};
+      while (pc != last) {
+        result |= run(slice, pc);
+        // No need to look at the remaining operands once all rows match.
+        if (all<1>(result))
+          pc = last;
+      }
+      return result;
+    }
+    case opcode::negation:
+      return ~run(slice, pc);
+  }
+  die("unhandled opcode in candidate checker");
+}
+
+} // namespace vast
@@ -13,14 +13,22 @@
 
 #include "vast/column_index.hpp"
 
+#include "vast/chunk.hpp"
 #include "vast/expression_visitors.hpp"
+#include "vast/fbs/utils.hpp"
+#include "vast/fbs/value_index.hpp"
+#include "vast/io/read.hpp"
+#include "vast/io/save.hpp"
 #include "vast/load.hpp"
 #include "vast/logger.hpp"
 #include "vast/save.hpp"
 #include "vast/table_slice.hpp"
 #include "vast/table_slice_column.hpp"
+#include "vast/time.hpp"
 #include "vast/value_index_factory.hpp"
 
+#include <chrono>
+
 namespace vast {
 
 // -- free functions -----------------------------------------------------------
@@ -57,12 +65,37 @@ caf::error column_index::init() {
   VAST_TRACE("");
   // Materialize the index when encountering persistent state.
   if (exists(filename_)) {
-    if (auto err = load(nullptr, filename_, last_flush_, idx_)) {
-      VAST_ERROR(this, "failed to load value index from disk", sys_.render(err));
-      return err;
+    auto start = std::chrono::steady_clock::now();
+    auto buffer = io::read(filename_);
+    if (!buffer) {
+      VAST_ERROR(this, "failed to read value index from disk",
+                 sys_.render(buffer.error()));
+      return buffer.error();
+    }
+    auto bytes = span<const byte>{*buffer};
+    auto data = reinterpret_cast<const uint8_t*>(bytes.data());
+    auto min_size
+      = sizeof(flatbuffers::uoffset_t) + flatbuffers::kFileIdentifierLength;
+    if (bytes.size() < min_size
+        || !flatbuffers::BufferHasIdentifier(data, fbs::file_identifier)) {
+      // Indexes written before the introduction of the flatbuffers format
+      // are CAF binary; the next flush converts them to the new format.
+      if (auto err = load(nullptr, filename_, last_flush_, idx_)) {
+        VAST_ERROR(this, "failed to load value index from disk",
+                   sys_.render(err));
+        return err;
+      }
     } else {
-      VAST_DEBUG(this, "loaded value index with offset", idx_->offset());
+      if (auto err = fbs::unwrap<fbs::ValueIndex>(bytes, idx_)) {
+        VAST_ERROR(this, "failed to load value index from disk",
+                   sys_.render(err));
+        return err;
+      }
+      last_flush_ = idx_->offset();
     }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    VAST_DEBUG(this, "loaded value index with offset", idx_->offset(), "in",
+               std::chrono::duration_cast<duration>(elapsed));
     return caf::none;
   }
   // Otherwise construct a new one.
@@ -85,7 +118,13 @@ caf::error column_index::flush_to_disk() {
   VAST_DEBUG(this, "flushes index (", offset - last_flush_, '/', offset,
              "new/total bits)");
   last_flush_ = offset;
-  return save(nullptr, filename_, last_flush_, idx_);
+  auto flatbuf = fbs::wrap(idx_, fbs::file_identifier);
+  if (!flatbuf) {
+    // Fall back to CAF binary for index types without flatbuffer support.
+    VAST_DEBUG(this, "failed to pack value index:", sys_.render(flatbuf.error()));
+    return save(nullptr, filename_, last_flush_, idx_);
+  }
+  return io::save(filename_, as_bytes(*flatbuf));
 }
 
 // -- properties -------------------------------------------------------------
@@ -107,6 +146,43 @@ caf::expected<bitmap> column_index::lookup(relational_operator op,
   return result;
 }
 
+std::vector<caf::expected<bitmap>>
+column_index::lookup(const std::vector<curried_predicate>& xs) {
+  VAST_TRACE("");
+  VAST_ASSERT(idx_ != nullptr);
+  std::vector<caf::expected<bitmap>> result(xs.size(), bitmap{});
+  // Group the predicates by operator and perform one batched lookup per group.
+  std::vector<bool> done(xs.size(), false);
+  std::vector<data_view> values;
+  std::vector<size_t> positions;
+  for (size_t i = 0; i < xs.size(); ++i) {
+    if (done[i])
+      continue;
+    auto op = xs[i].op;
+    values.clear();
+    positions.clear();
+    for (auto j = i; j < xs.size(); ++j) {
+      if (!done[j] && xs[j].op == op) {
+        values.push_back(to_internal(index_type_, make_view(xs[j].rhs)));
+        positions.push_back(j);
+        done[j] = true;
+      }
+    }
+    if (auto hits = idx_->lookup_batch(op, values)) {
+      for (size_t j = 0; j < positions.size(); ++j)
+        result[positions[j]] = std::move((*hits)[j]);
+    } else {
+      // A single failing predicate fails the entire batch, so we fall back to
+      // separate lookups to keep the results of all other predicates.
+      VAST_DEBUG(this, "retries", positions.size(),
+                 "predicates individually after", hits.error());
+      for (size_t j = 0; j < positions.size(); ++j)
+        result[positions[j]] = idx_->lookup(op, values[j]);
+    }
+  }
+  return result;
+}
+
 bool column_index::dirty() const noexcept {
   VAST_ASSERT(idx_ != nullptr);
   return idx_->offset() != last_flush_;
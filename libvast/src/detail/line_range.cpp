@@ -15,19 +15,42 @@
 
 #include "vast/detail/fdinbuf.hpp"
 #include "vast/detail/getline_generic.hpp"
+#include "vast/detail/mmapbuf.hpp"
+
+#include <cstring>
 
 namespace vast {
 namespace detail {
 
 line_range::line_range(std::istream& input) : input_{input} {
+  auto sb = dynamic_cast<mmapbuf*>(input_.rdbuf());
+  if (sb && sb->data() != nullptr) {
+    auto pos = sb->pubseekoff(0, std::ios_base::cur, std::ios_base::in);
+    mapped_ = sb->data() + static_cast<std::streamoff>(pos);
+    mapped_end_ = sb->data() + sb->size();
+  }
 }
 
 const std::string& line_range::get() const {
+  if (!materialized_) {
+    line_.assign(current_.data(), current_.size());
+    materialized_ = true;
+  }
   return line_;
 }
 
+std::string_view line_range::view() const {
+  if (mapped_end_ == nullptr)
+    return line_;
+  return current_;
+}
+
 void line_range::next() {
   VAST_ASSERT(!done());
+  if (mapped_end_ != nullptr) {
+    next_mapped();
+    return;
+  }
   line_.clear();
   if (!input_)
     return;
@@ -40,6 +63,11 @@ void line_range::next() {
 }
 
 bool line_range::next_timeout(std::chrono::milliseconds timeout) {
+  // Mapped input is always available, so reading cannot time out.
+  if (mapped_end_ != nullptr) {
+    next();
+    return false;
+  }
   auto* p = dynamic_cast<fdinbuf*>(input_.rdbuf());
   if (p)
     p->read_timeout() = timeout;
@@ -57,10 +85,13 @@ bool line_range::next_timeout(std::chrono::milliseconds timeout) {
 }
 
 bool line_range::done() const {
+  if (mapped_end_ != nullptr)
+    return current_.empty() && mapped_ == mapped_end_;
   return line_.empty() && !input_;
 }
 
 std::string& line_range::line() {
+  get();
   return line_;
 }
 
@@ -68,5 +99,29 @@ size_t line_range::line_number() const {
   return line_number_;
 }
 
+void line_range::next_mapped() {
+  line_.clear();
+  current_ = {};
+  materialized_ = false;
+  // Get the next non-empty line. Like getline_generic, we recognize any of
+  // `\n`, `\r\n` and `\r` as line delimiter.
+  while (current_.empty() && mapped_ != mapped_end_) {
+    auto first = mapped_;
+    auto size = static_cast<size_t>(mapped_end_ - first);
+    auto nl = static_cast<const char*>(std::memchr(first, '\n', size));
+    auto last = nl != nullptr ? nl : mapped_end_;
+    auto cr = static_cast<const char*>(
+      std::memchr(first, '\r', static_cast<size_t>(last - first)));
+    if (cr != nullptr) {
+      last = cr;
+      mapped_ = cr + 1 != mapped_end_ && cr[1] == '\n' ? cr + 2 : cr + 1;
+    } else {
+      mapped_ = nl != nullptr ? nl + 1 : mapped_end_;
+    }
+    current_ = std::string_view{first, static_cast<size_t>(last - first)};
+    ++line_number_;
+  }
+}
+
 } // namespace detail
 } // namespace vast
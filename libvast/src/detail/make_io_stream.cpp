@@ -17,6 +17,7 @@
 #include "vast/detail/assert.hpp"
 #include "vast/detail/fdinbuf.hpp"
 #include "vast/detail/fdostream.hpp"
+#include "vast/detail/mmapbuf.hpp"
 #include "vast/detail/posix.hpp"
 #include "vast/error.hpp"
 #include "vast/path.hpp"
@@ -67,6 +68,10 @@ make_input_stream(const std::string& input, path::type pt) {
       if (!exists(input))
         return make_error(ec::filesystem_error, "file does not exist at",
                           input);
+      // Map regular files into memory such that detail::line_range can
+      // iterate over their lines without copying.
+      if (auto mb = mmapbuf::map_readonly(input))
+        return std::make_unique<owning_istream>(std::move(mb));
       auto fb = std::make_unique<std::filebuf>();
       fb->open(input, std::ios_base::binary | std::ios_base::in);
       return std::make_unique<owning_istream>(std::move(fb));
@@ -78,6 +78,34 @@ mmapbuf::mmapbuf(const path& filename, size_t size, size_t offset)
   setg(map_, map_, map_ + size_);
 }
 
+std::unique_ptr<mmapbuf> mmapbuf::map_readonly(const path& filename) {
+  auto fd = open(filename.str().c_str(), O_RDONLY);
+  if (fd == -1)
+    return nullptr;
+  struct stat st;
+  if (::fstat(fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+    close(fd);
+    return nullptr;
+  }
+  auto size = static_cast<size_t>(st.st_size);
+  auto map = mmap(nullptr, size, PROT_READ, MAP_FILE | MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED) {
+    close(fd);
+    return nullptr;
+  }
+  // The hint only affects read-ahead, so we can safely ignore failures.
+  madvise(map, size, MADV_SEQUENTIAL);
+  auto result = std::make_unique<mmapbuf>();
+  result->filename_ = filename;
+  result->fd_ = fd;
+  result->size_ = size;
+  result->prot_ = PROT_READ;
+  result->flags_ = MAP_FILE | MAP_PRIVATE;
+  result->map_ = reinterpret_cast<char_type*>(map);
+  result->setg(result->map_, result->map_, result->map_ + size);
+  return result;
+}
+
 mmapbuf::~mmapbuf() {
   if (map_)
     munmap(map_, size_);
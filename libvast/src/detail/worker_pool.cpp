@@ -0,0 +1,79 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/detail/worker_pool.hpp"
+
+namespace vast::detail {
+
+worker_pool::worker_pool(size_t size) {
+  for (size_t i = 1; i < size; ++i)
+    workers_.emplace_back([this] { work(); });
+}
+
+worker_pool::~worker_pool() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_ = true;
+  }
+  work_available_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+}
+
+size_t worker_pool::size() const noexcept {
+  return workers_.size() + 1;
+}
+
+void worker_pool::run(size_t n, std::function<void(size_t)> f) {
+  if (n == 0)
+    return;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    task_ = std::move(f);
+    num_tasks_ = n;
+    next_task_ = 0;
+    busy_workers_ = workers_.size();
+    ++batch_;
+  }
+  work_available_.notify_all();
+  drain();
+  // The task may refer to state of the caller, so we must not return before
+  // every worker left the batch.
+  std::unique_lock<std::mutex> lock{mutex_};
+  work_done_.wait(lock, [&] { return busy_workers_ == 0; });
+  task_ = nullptr;
+}
+
+void worker_pool::drain() {
+  for (auto i = next_task_++; i < num_tasks_; i = next_task_++)
+    task_(i);
+}
+
+void worker_pool::work() {
+  size_t batch = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      work_available_.wait(lock, [&] { return stop_ || batch_ != batch; });
+      if (stop_)
+        return;
+      batch = batch_;
+    }
+    drain();
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (--busy_workers_ == 0)
+      work_done_.notify_one();
+  }
+}
+
+} // namespace vast::detail
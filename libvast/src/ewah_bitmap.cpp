@@ -19,6 +19,12 @@ ewah_bitmap::ewah_bitmap(size_type n, bool bit) {
   append_bits(bit, n);
 }
 
+ewah_bitmap::ewah_bitmap(block_vector blocks, size_type last_marker,
+                         size_type num_bits)
+  : blocks_{std::move(blocks)}, last_marker_{last_marker}, num_bits_{num_bits} {
+  VAST_ASSERT(blocks_.empty() || last_marker_ < blocks_.size());
+}
+
 bool ewah_bitmap::empty() const {
   return num_bits_ == 0;
 }
@@ -31,6 +37,10 @@ const ewah_bitmap::block_vector& ewah_bitmap::blocks() const {
   return blocks_;
 }
 
+ewah_bitmap::size_type ewah_bitmap::last_marker() const {
+  return last_marker_;
+}
+
 void ewah_bitmap::append_bit(bool bit) {
   auto partial = num_bits_ % word_type::width;
   if (blocks_.empty()) {
@@ -14,8 +14,13 @@
 #include "vast/fbs/utils.hpp"
 
 #include "vast/chunk.hpp"
+#include "vast/detail/narrow.hpp"
 #include "vast/error.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
 namespace vast::fbs {
 
 chunk_ptr release(flatbuffers::FlatBufferBuilder& builder) {
@@ -28,7 +33,19 @@ chunk_ptr release(flatbuffers::FlatBufferBuilder& builder) {
 
 flatbuffers::Verifier make_verifier(span<const byte> xs) {
   auto data = reinterpret_cast<const uint8_t*>(xs.data());
-  return flatbuffers::Verifier{data, xs.size()};
+  // Value indexes consist of many small tables, e.g., a string index has one
+  // table per bitmap of every character position, and nest them deeper than
+  // most flatbuffers. Since every table occupies at least the offset to its
+  // vtable, the buffer size bounds the number of tables in a buffer that we
+  // wrote ourselves.
+  constexpr flatbuffers::uoffset_t max_depth = 128;
+  constexpr size_t min_max_tables = 1'000'000;
+  auto max_tables = std::clamp(xs.size() / sizeof(flatbuffers::soffset_t),
+                               min_max_tables,
+                               size_t{std::numeric_limits<uint32_t>::max()});
+  return flatbuffers::Verifier{data, xs.size(), max_depth,
+                               detail::narrow_cast<flatbuffers::uoffset_t>(
+                                 max_tables)};
 }
 
 caf::error check_version(Version given, Version expected) {
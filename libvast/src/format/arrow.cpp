@@ -20,6 +20,7 @@
 #include "vast/detail/fdoutbuf.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/error.hpp"
+#include "vast/logger.hpp"
 #include "vast/table_slice_builder.hpp"
 #include "vast/type.hpp"
 
@@ -27,16 +28,78 @@
 
 #include <arrow/util/io_util.h>
 
+#include <ostream>
 #include <stdexcept>
 
 namespace vast::format::arrow {
 
+namespace {
+
+/// Adapts a C++ output stream to the Arrow output stream interface.
+class ostream_adapter : public ::arrow::io::OutputStream {
+public:
+  explicit ostream_adapter(std::unique_ptr<std::ostream> out)
+    : out_{std::move(out)} {
+    // nop
+  }
+
+  bool closed() const override {
+    return out_ == nullptr;
+  }
+
+  ::arrow::Status Close() override {
+    auto status = Flush();
+    out_ = nullptr;
+    return status;
+  }
+
+  ::arrow::Result<int64_t> Tell() const override {
+    return position_;
+  }
+
+  ::arrow::Status Write(const void* data, int64_t nbytes) override {
+    if (out_ == nullptr)
+      return ::arrow::Status::IOError("stream closed");
+    out_->write(static_cast<const char*>(data), nbytes);
+    if (!*out_)
+      return ::arrow::Status::IOError("failed to write to stream");
+    position_ += nbytes;
+    return ::arrow::Status::OK();
+  }
+
+  ::arrow::Status Flush() override {
+    if (out_ != nullptr && !out_->flush())
+      return ::arrow::Status::IOError("failed to flush stream");
+    return ::arrow::Status::OK();
+  }
+
+private:
+  std::unique_ptr<std::ostream> out_;
+  int64_t position_ = 0;
+};
+
+} // namespace
+
 writer::writer() {
   out_ = std::make_shared<::arrow::io::StdoutStream>();
 }
 
+writer::writer(std::unique_ptr<std::ostream> out) {
+  out_ = std::make_shared<ostream_adapter>(std::move(out));
+}
+
 writer::~writer() {
-  // nop
+  // Write the rows that are still pending in the builder, because the sink
+  // does not necessarily flush before it shuts down.
+  if (out_ == nullptr)
+    return;
+  if (auto err = finish_batch())
+    VAST_ERROR(this, "failed to write pending rows:", err);
+  if (current_batch_writer_ != nullptr
+      && !current_batch_writer_->Close().ok())
+    VAST_ERROR(this, "failed to close the Arrow stream");
+  if (!out_->Flush().ok())
+    VAST_ERROR(this, "failed to flush the Arrow stream");
 }
 
 caf::error writer::write(const table_slice& slice) {
@@ -44,29 +107,38 @@ caf::error writer::write(const table_slice& slice) {
     return ec::filesystem_error;
   if (!layout(slice.layout()))
     return ec::unspecified;
-  // Convert the slice to Arrow if necessary.
+  // Pass Arrow record batches through as-is. Rows of other encodings may
+  // still be pending in the builder, so we write these first to retain the
+  // order of events.
   if (slice.implementation_id() == arrow_table_slice::class_id) {
-    auto dref = static_cast<const arrow_table_slice&>(slice);
-    if (auto err = write_arrow_batches(dref))
-      return err;
-  } else {
-    // TODO: consider iterating the slice in its natural order (i.e., row major
-    //       or column major).
-    for (size_t row = 0; row < slice.rows(); ++row)
-      for (size_t column = 0; column < slice.columns(); ++column)
-        if (!current_builder_->add(slice.at(row, column)))
-          return ec::type_clash;
-    auto slice_copy = current_builder_->finish();
-    if (slice_copy == nullptr)
-      return ec::invalid_table_slice_type;
-    VAST_ASSERT(slice_copy->implementation_id() == arrow_table_slice::class_id);
-    auto dref = static_cast<const arrow_table_slice&>(*slice_copy);
-    if (auto err = write_arrow_batches(dref))
+    if (auto err = finish_batch())
       return err;
+    auto& dref = static_cast<const arrow_table_slice&>(slice);
+    return write_arrow_batches(dref);
+  }
+  // TODO: consider iterating the slice in its natural order (i.e., row major
+  //       or column major).
+  for (size_t row = 0; row < slice.rows(); ++row) {
+    for (size_t column = 0; column < slice.columns(); ++column)
+      if (!current_builder_->add(slice.at(row, column)))
+        return ec::type_clash;
+    if (current_builder_->rows() >= defaults::batch_size)
+      if (auto err = finish_batch())
+        return err;
   }
   return caf::none;
 }
 
+caf::expected<void> writer::flush() {
+  if (out_ == nullptr)
+    return caf::no_error;
+  if (auto err = finish_batch())
+    return err;
+  if (!out_->Flush().ok())
+    return make_error(ec::filesystem_error, "failed to flush Arrow stream");
+  return caf::no_error;
+}
+
 const char* writer::name() const {
   return "arrow-writer";
 }
@@ -74,6 +146,8 @@ const char* writer::name() const {
 bool writer::layout(const record_type& x) {
   if (current_layout_ == x)
     return true;
+  if (finish_batch())
+    return false;
   if (current_batch_writer_ != nullptr) {
     if (!current_batch_writer_->Close().ok())
       return false;
@@ -100,4 +174,14 @@ caf::error writer::write_arrow_batches(const arrow_table_slice& x) {
   return caf::none;
 }
 
+caf::error writer::finish_batch() {
+  if (current_builder_ == nullptr || current_builder_->rows() == 0)
+    return caf::none;
+  auto slice = current_builder_->finish();
+  if (slice == nullptr)
+    return ec::invalid_table_slice_type;
+  VAST_ASSERT(slice->implementation_id() == arrow_table_slice::class_id);
+  return write_arrow_batches(static_cast<const arrow_table_slice&>(*slice));
+}
+
 } // namespace vast::format::arrow
@@ -29,6 +29,7 @@
 
 #include <caf/settings.hpp>
 
+#include <cstring>
 #include <ostream>
 #include <string_view>
 #include <type_traits>
@@ -125,8 +126,10 @@ caf::error writer::write(const table_slice& x) {
         return err;
     }
     append('\n');
-    write_buf();
+    if (buf_.size() >= max_buffer_size)
+      write_buf();
   }
+  write_buf();
   return caf::none;
 }
 
@@ -381,6 +384,55 @@ make_csv_parser(const record_type& layout, table_slice_builder_ptr builder,
   return result;
 }
 
+/// Parses a field that contains exactly one value of type `T`. An empty field
+/// yields `nil`, just like the optional parsers of the generic path.
+template <class T>
+bool parse_field(std::string_view str, data_view& x) {
+  if (str.empty()) {
+    x = caf::none;
+    return true;
+  }
+  if constexpr (std::is_same_v<T, std::string>) {
+    x = make_view(str);
+    return true;
+  } else {
+    T y;
+    auto f = str.begin();
+    auto l = str.end();
+    if (!make_parser<T>{}(f, l, y) || f != l)
+      return false;
+    x = make_view(y);
+    return true;
+  }
+}
+
+/// Selects the type-specialized parser for a column, if there is one.
+struct field_parser_factory {
+  template <class T>
+  reader::field_parser operator()(const T&) const {
+    // Types that cannot contain the separator and that do not depend on
+    // attributes, e.g., the unit of a duration.
+    if constexpr (detail::is_any_v<T, bool_type, integer_type, count_type,
+                                   real_type, time_type, string_type,
+                                   address_type, subnet_type>)
+      return parse_field<type_to_data<T>>;
+    else
+      return nullptr;
+  }
+};
+
+std::vector<reader::field_parser> make_field_parsers(const record_type& layout) {
+  std::vector<reader::field_parser> result;
+  result.reserve(layout.fields.size());
+  for (auto& field : layout.fields) {
+    auto p = caf::visit(field_parser_factory{}, field.type);
+    if (!p)
+      return {};
+    result.push_back(p);
+  }
+  return result;
+}
+
 } // namespace
 
 vast::system::report reader::status() const {
@@ -416,9 +468,42 @@ caf::expected<reader::parser_type> reader::read_header(std::string_view line) {
   auto parser = make_csv_parser<iterator_type>(*layout, builder_, opt_);
   if (!parser)
     return make_error(ec::parse_error, "unable to generate a parser");
+  field_parsers_ = make_field_parsers(*layout);
+  if (!field_parsers_.empty()) {
+    VAST_DEBUG(this, "uses type-specialized field parsers");
+    row_.resize(field_parsers_.size());
+  }
   return *parser;
 }
 
+bool reader::parse_fields(std::string_view line) {
+  // Split the line first, so that we can reject a line with the wrong number
+  // of fields before parsing any of them.
+  fields_.clear();
+  auto f = line.data();
+  auto l = f + line.size();
+  while (true) {
+    auto i = static_cast<const char*>(std::memchr(f, opt_.separator, l - f));
+    if (!i) {
+      fields_.emplace_back(f, l - f);
+      break;
+    }
+    fields_.emplace_back(f, i - f);
+    f = i + 1;
+  }
+  if (fields_.size() != field_parsers_.size())
+    return false;
+  // Parse all fields before adding any of them, so that an invalid line
+  // leaves no partial row behind in the builder.
+  for (size_t i = 0; i < fields_.size(); ++i)
+    if (!field_parsers_[i](fields_[i], row_[i]))
+      return false;
+  for (auto& x : row_)
+    if (!builder_->add(x))
+      return false;
+  return true;
+}
+
 caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
                              consumer& callback) {
   VAST_ASSERT(max_events > 0);
@@ -455,17 +540,19 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       VAST_DEBUG(this, "reached input timeout at line", lines_->line_number());
       return finish(callback, ec::timeout);
     }
-    auto& line = lines_->get();
+    auto line = lines_->view();
     if (line.empty()) {
       // Ignore empty lines.
       VAST_DEBUG(this, "ignores empty line at", lines_->line_number());
       continue;
     }
     ++num_lines_;
-    if (!p(line)) {
+    auto parsed
+      = field_parsers_.empty() ? p(lines_->get()) : parse_fields(line);
+    if (!parsed) {
       if (num_invalid_lines_ == 0)
         VAST_WARNING(this, "failed to parse line", lines_->line_number(), ":",
-                     line);
+                     lines_->get());
       ++num_invalid_lines_;
       continue;
     }
@@ -22,6 +22,7 @@
 #include "vast/concept/printable/vast/json.hpp"
 #include "vast/data.hpp"
 #include "vast/format/json.hpp"
+#include "vast/format/json/field_index.hpp"
 #include "vast/logger.hpp"
 #include "vast/policy/include_field_names.hpp"
 #include "vast/table_slice.hpp"
@@ -33,6 +34,10 @@
 #include <caf/expected.hpp>
 #include <caf/none.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+
 namespace vast::format::json {
 namespace {
 
@@ -208,8 +213,321 @@ const vast::json* lookup(std::string_view field, const vast::json::object& xs) {
   return lookup(field, *obj);
 }
 
+bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+template <class Iterator>
+void skip_space(Iterator& f, Iterator l) {
+  while (f != l && is_space(*f))
+    ++f;
+}
+
+// Advances past a JSON string, starting at its opening quote.
+template <class Iterator>
+bool skip_string(Iterator& f, Iterator l) {
+  VAST_ASSERT(f != l && *f == '"');
+  for (++f; f != l; ++f) {
+    if (*f == '\\') {
+      if (++f == l)
+        return false;
+    } else if (*f == '"') {
+      ++f;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class Iterator>
+bool skip_literal(Iterator& f, Iterator l, std::string_view literal) {
+  auto remaining = static_cast<size_t>(std::distance(f, l));
+  if (remaining < literal.size()
+      || std::string_view{&*f, literal.size()} != literal)
+    return false;
+  f += literal.size();
+  return true;
+}
+
+template <class Iterator>
+std::string_view make_string_view(Iterator f, Iterator l) {
+  return {&*f, static_cast<size_t>(std::distance(f, l))};
+}
+
+// Parses an unparsed JSON value from a field index. Only lists and maps
+// require a full parse; all other values map to a JSON scalar directly.
+bool parse_value(std::string_view str, vast::json& x) {
+  VAST_ASSERT(!str.empty());
+  switch (str.front()) {
+    case '"': {
+      std::string result;
+      if (!parsers::qqstr(str, result))
+        return false;
+      x = std::move(result);
+      return true;
+    }
+    case 't':
+    case 'f': {
+      bool result;
+      if (!parsers::json_boolean(str, result))
+        return false;
+      x = result;
+      return true;
+    }
+    case 'n':
+      x = vast::json{};
+      return str == "null";
+    case '[':
+    case '{':
+      return parsers::json(str, x);
+    default: {
+      vast::json::number result;
+      if (!parsers::json_number(str, result))
+        return false;
+      x = result;
+      return true;
+    }
+  }
+}
+
+constexpr auto no_column = std::numeric_limits<size_t>::max();
+
 } // namespace
 
+// -- field_index --------------------------------------------------------------
+
+bool field_index::reset(std::string_view str) {
+  size_ = 0;
+  path_.clear();
+  auto f = str.begin();
+  auto l = str.end();
+  skip_space(f, l);
+  if (f == l || *f != '{')
+    return false;
+  if (!scan_object(f, l, 0))
+    return false;
+  skip_space(f, l);
+  return f == l;
+}
+
+std::string_view field_index::find(std::string_view name) const {
+  for (size_t i = 0; i < size_; ++i)
+    if (fields_[i].name == name)
+      return fields_[i].value;
+  return {};
+}
+
+bool field_index::scan_object(iterator& f, iterator l, size_t prefix_size) {
+  VAST_ASSERT(f != l && *f == '{');
+  ++f;
+  skip_space(f, l);
+  if (f != l && *f == '}') {
+    ++f;
+    return true;
+  }
+  while (f != l) {
+    auto key_begin = f;
+    if (*f != '"' || !skip_string(f, l))
+      return false;
+    auto key = make_string_view(key_begin, f);
+    skip_space(f, l);
+    if (f == l || *f != ':')
+      return false;
+    ++f;
+    skip_space(f, l);
+    if (f == l)
+      return false;
+    // The index of the field remains stable while scanning nested objects,
+    // whereas a reference into the fields would not.
+    auto i = size_;
+    emplace_field(key, prefix_size);
+    auto value_begin = f;
+    if (*f == '{') {
+      if (!scan_object(f, l, path_.size()))
+        return false;
+    } else if (!scan_value(f, l)) {
+      return false;
+    }
+    fields_[i].value = make_string_view(value_begin, f);
+    skip_space(f, l);
+    if (f == l)
+      return false;
+    if (*f == '}') {
+      ++f;
+      return true;
+    }
+    if (*f != ',')
+      return false;
+    ++f;
+    skip_space(f, l);
+  }
+  return false;
+}
+
+bool field_index::scan_value(iterator& f, iterator l) {
+  VAST_ASSERT(f != l);
+  switch (*f) {
+    case '"':
+      return skip_string(f, l);
+    case '[': {
+      ++f;
+      skip_space(f, l);
+      if (f != l && *f == ']') {
+        ++f;
+        return true;
+      }
+      while (f != l) {
+        if (!scan_value(f, l))
+          return false;
+        skip_space(f, l);
+        if (f == l)
+          return false;
+        if (*f == ']') {
+          ++f;
+          return true;
+        }
+        if (*f != ',')
+          return false;
+        ++f;
+        skip_space(f, l);
+      }
+      return false;
+    }
+    case '{': {
+      // Objects nested in arrays do not contribute fields.
+      ++f;
+      skip_space(f, l);
+      if (f != l && *f == '}') {
+        ++f;
+        return true;
+      }
+      while (f != l) {
+        if (*f != '"' || !skip_string(f, l))
+          return false;
+        skip_space(f, l);
+        if (f == l || *f != ':')
+          return false;
+        ++f;
+        skip_space(f, l);
+        if (f == l || !scan_value(f, l))
+          return false;
+        skip_space(f, l);
+        if (f == l)
+          return false;
+        if (*f == '}') {
+          ++f;
+          return true;
+        }
+        if (*f != ',')
+          return false;
+        ++f;
+        skip_space(f, l);
+      }
+      return false;
+    }
+    case 't':
+      return skip_literal(f, l, "true");
+    case 'f':
+      return skip_literal(f, l, "false");
+    case 'n':
+      return skip_literal(f, l, "null");
+    default: {
+      // A number extends up to the next structural character. We validate it
+      // only when converting it into a column value.
+      auto first = f;
+      while (f != l && !is_space(*f) && *f != ',' && *f != '}' && *f != ']')
+        ++f;
+      return f != first;
+    }
+  }
+}
+
+field_index::field&
+field_index::emplace_field(std::string_view key, size_t prefix_size) {
+  VAST_ASSERT(key.size() >= 2);
+  path_.resize(prefix_size);
+  if (prefix_size > 0)
+    path_ += '.';
+  if (key.find('\\') == std::string_view::npos) {
+    path_.append(key.data() + 1, key.size() - 2);
+  } else {
+    // Escaped keys are rare, so we can afford to unescape them separately.
+    std::string unescaped;
+    parsers::qqstr(key, unescaped);
+    path_ += unescaped;
+  }
+  if (size_ == fields_.size())
+    fields_.emplace_back();
+  auto& result = fields_[size_++];
+  result.name.assign(path_);
+  result.value = {};
+  return result;
+}
+
+// -- column_extractor ---------------------------------------------------------
+
+column_extractor::column_extractor(record_type layout)
+  : layout_{std::move(layout)} {
+  for (size_t i = 0; i < layout_.fields.size(); ++i)
+    columns_.emplace(layout_.fields[i].name, i);
+  values_.resize(layout_.fields.size());
+}
+
+caf::error
+column_extractor::extract(const field_index& xs, std::vector<data>& row) {
+  std::fill(values_.begin(), values_.end(), std::string_view{});
+  if (hints_.size() < xs.size())
+    hints_.resize(xs.size(), no_column);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    // Like the lookup in a JSON object, the first occurrence of a field wins.
+    auto c = column(xs, i);
+    if (c != no_column && values_[c].empty())
+      values_[c] = xs[i].value;
+  }
+  row.resize(values_.size());
+  vast::json j;
+  for (size_t c = 0; c < values_.size(); ++c) {
+    auto& field = layout_.fields[c];
+    auto str = values_[c];
+    // Non-existing fields are treated as empty (unset).
+    if (str.empty() || str == "null") {
+      row[c] = caf::none;
+      continue;
+    }
+    // Strings without escape sequences need no parsing, and we copy them into
+    // the string that the row holds from the previous object if possible.
+    if (caf::holds_alternative<string_type>(field.type) && str.front() == '"'
+        && str.find('\\') == std::string_view::npos) {
+      str = str.substr(1, str.size() - 2);
+      if (auto s = caf::get_if<std::string>(&row[c]))
+        s->assign(str.data(), str.size());
+      else
+        row[c] = std::string{str};
+      continue;
+    }
+    if (!parse_value(str, j))
+      return make_error(ec::parse_error, "malformed value for", field.name,
+                        ":", std::string{str});
+    auto x = caf::visit(convert{}, j, field.type);
+    if (!x)
+      return make_error(ec::convert_error, x.error().context(),
+                        "could not convert", field.name, ":", std::string{str});
+    row[c] = std::move(*x);
+  }
+  return caf::none;
+}
+
+size_t column_extractor::column(const field_index& xs, size_t i) {
+  auto& name = xs[i].name;
+  auto c = hints_[i];
+  if (c != no_column && layout_.fields[c].name == name)
+    return c;
+  auto it = columns_.find(std::string_view{name});
+  c = it != columns_.end() ? it->second : no_column;
+  hints_[i] = c;
+  return c;
+}
+
 caf::error writer::write(const table_slice& x) {
   json_printer<policy::oneline> printer;
   return print<policy::include_field_names>(printer, x, "{", ", ", "}");
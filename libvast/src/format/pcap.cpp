@@ -15,6 +15,7 @@
 
 #include "vast/byte.hpp"
 #include "vast/community_id.hpp"
+#include "vast/config.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/time.hpp"
 #include "vast/defaults.hpp"
@@ -31,12 +32,22 @@
 #include <caf/config_value.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <netinet/in.h>
 
+#if VAST_LINUX
+#  include <linux/if_packet.h>
+#  include <sys/socket.h>
+#endif
+
 namespace vast {
 namespace format {
 namespace pcap {
@@ -78,11 +89,23 @@ reader::reader(caf::atom_value id, const caf::settings& options,
   pseudo_realtime_ = get_or(options, category + ".pseudo-realtime-factor",
                             defaults_t::pseudo_realtime_factor);
   snaplen_ = get_or(options, category + ".snaplen", defaults_t::snaplen);
+  buffer_size_
+    = get_or(options, category + ".buffer-size", defaults_t::buffer_size);
+  if (auto group = get_if<size_t>(&options, category + ".fanout-group")) {
+    if (*group > std::numeric_limits<uint16_t>::max())
+      VAST_WARNING(this, "ignores invalid fanout group", *group);
+    else
+      fanout_group_ = static_cast<uint16_t>(*group);
+  }
   drop_rate_threshold_
     = get_or(options, category + ".drop-rate-threshold", 0.05);
   community_id_ = !get_or(options, category + ".disable-community-id", false);
   packet_type_
     = community_id_ ? pcap_packet_type_community_id : pcap_packet_type;
+  parse_threads_ = get_or(options, "import.parse-threads",
+                          vast::defaults::import::parse_threads);
+  if (parse_threads_ == 0)
+    parse_threads_ = std::max(1u, std::thread::hardware_concurrency());
   last_stats_ = {};
   discard_count_ = 0;
   if (auto read_timeout_arg = caf::get_if<std::string>(&options, "import.batch-"
@@ -221,11 +244,8 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
   if (!pcap_) {
     // Determine interfaces.
     if (interface_) {
-      pcap_ = ::pcap_open_live(interface_->c_str(), snaplen_, 1, 1000, buf);
-      if (!pcap_) {
-        return make_error(ec::format_error, "failed to open interface",
-                          *interface_, ":", buf);
-      }
+      if (auto err = open_live())
+        return err;
       if (pseudo_realtime_ > 0) {
         pseudo_realtime_ = 0;
         VAST_WARNING(this, "ignores pseudo-realtime in live mode");
@@ -243,7 +263,8 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       pcap_ = ::pcap_open_offline(input_.c_str(), buf);
 #endif
       if (!pcap_) {
-        flows_.clear();
+        for (auto& flows : flows_)
+          flows.clear();
         return make_error(ec::format_error, "failed to open pcap file ", input_,
                           ": ", std::string{buf});
       }
@@ -257,8 +278,24 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
     VAST_VERBOSE(this, "evicts flows after", max_age_, "s of inactivity");
     VAST_VERBOSE(this, "expires flow table every", expire_interval_, "s");
   }
+  if (flows_.empty()) {
+    // Pacing packets in pseudo-realtime requires processing them one by one.
+    auto shards = pseudo_realtime_ > 0 ? size_t{1} : parse_threads_;
+    if (shards > 1)
+      VAST_VERBOSE(this, "tracks flows with", shards, "threads");
+    for (size_t i = 0; i < shards; ++i)
+      flows_.emplace_back(cutoff_, std::max(max_flows_ / shards, size_t{1}),
+                          max_age_, expire_interval_);
+    if (shards > 1) {
+      shard_packets_.resize(shards);
+      workers_ = std::make_unique<detail::worker_pool>(shards);
+    }
+  }
+  if (flows_.size() > 1)
+    return read_parallel(max_events, max_slice_size, f);
   auto start = std::chrono::steady_clock::now();
   auto produced = size_t{0};
+  packet p;
   while (produced < max_events) {
     // We must check not only for a timeout but also whether any events were
     // produced to work around CAF's assumption that sources are always able to
@@ -286,133 +323,34 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       return finish(f, make_error(ec::format_error,
                                   "failed to get next packet: ", err));
     }
-    // Parse frame.
-    span<const byte> frame{reinterpret_cast<const byte*>(data), header->len};
-    frame = decapsulate(frame, frame_type::ethernet);
-    if (frame.empty())
-      return make_error(ec::format_error, "failed to decapsulate frame");
-    constexpr size_t ethernet_header_size = 14;
-    auto layer3 = frame.subspan<ethernet_header_size>();
-    span<const byte> layer4;
-    uint8_t layer4_proto = 0;
-    flow conn;
-    // Parse layer 3.
-    switch (as_ether_type(frame.subspan<12, 2>())) {
-      default: {
-        ++discard_count_;
-        VAST_DEBUG(this, "skips non-IP packet");
-        continue;
-      }
-      case ether_type::ipv4: {
-        constexpr size_t ipv4_header_size = 20;
-        if (header->len < ethernet_header_size + ipv4_header_size)
-          return make_error(ec::format_error, "IPv4 header too short");
-        size_t header_size = (to_integer<uint8_t>(layer3[0]) & 0x0f) * 4;
-        if (header_size < ipv4_header_size)
-          return make_error(ec::format_error,
-                            "IPv4 header too short: ", header_size, " bytes");
-        auto orig_h
-          = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 12));
-        auto resp_h
-          = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 16));
-        conn.src_addr = {orig_h, address::ipv4, address::network};
-        conn.dst_addr = {resp_h, address::ipv4, address::network};
-        layer4_proto = to_integer<uint8_t>(layer3[9]);
-        layer4 = layer3.subspan(header_size);
-        break;
-      }
-      case ether_type::ipv6: {
-        if (header->len < ethernet_header_size + 40)
-          return make_error(ec::format_error, "IPv6 header too short");
-        auto orig_h
-          = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 8));
-        auto resp_h
-          = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 24));
-        conn.src_addr = {orig_h, address::ipv4, address::network};
-        conn.dst_addr = {resp_h, address::ipv4, address::network};
-        layer4_proto = to_integer<uint8_t>(layer3[6]);
-        layer4 = layer3.subspan(40);
-        break;
-      }
-    }
-    // Parse layer 4.
-    auto payload_size = layer4.size();
-    if (layer4_proto == IPPROTO_TCP) {
-      VAST_ASSERT(!layer4.empty());
-      auto orig_p
-        = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data()));
-      auto resp_p
-        = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data() + 2));
-      orig_p = detail::to_host_order(orig_p);
-      resp_p = detail::to_host_order(resp_p);
-      conn.src_port = {orig_p, port::tcp};
-      conn.dst_port = {resp_p, port::tcp};
-      auto data_offset
-        = *reinterpret_cast<const uint8_t*>(std::launder(layer4.data() + 12))
-          >> 4;
-      payload_size -= data_offset * 4;
-    } else if (layer4_proto == IPPROTO_UDP) {
-      VAST_ASSERT(!layer4.empty());
-      auto orig_p
-        = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data()));
-      auto resp_p
-        = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data() + 2));
-      orig_p = detail::to_host_order(orig_p);
-      resp_p = detail::to_host_order(resp_p);
-      conn.src_port = {orig_p, port::udp};
-      conn.dst_port = {resp_p, port::udp};
-      payload_size -= 8;
-    } else if (layer4_proto == IPPROTO_ICMP) {
-      VAST_ASSERT(!layer4.empty());
-      auto message_type = to_integer<uint8_t>(layer4[0]);
-      auto message_code = to_integer<uint8_t>(layer4[1]);
-      conn.src_port = {message_type, port::icmp};
-      conn.dst_port = {message_code, port::icmp};
-      payload_size -= 8; // TODO: account for variable-size data.
+    auto is_ip = decode(*header, data, p);
+    if (!is_ip)
+      return is_ip.error();
+    if (!*is_ip) {
+      ++discard_count_;
+      VAST_DEBUG(this, "skips non-IP packet");
+      continue;
     }
-    // Parse packet timestamp
-    uint64_t packet_time = header->ts.tv_sec;
-    if (last_expire_ == 0)
-      last_expire_ = packet_time;
-    if (!update_flow(conn, packet_time, payload_size)) {
+    auto st = flows_[0].update(p.conn, p.packet_time, p.payload_size);
+    if (st == nullptr) {
       ++discard_count_;
       VAST_DEBUG(this, "skips cut off packet");
       continue;
     }
-    evict_inactive(packet_time);
-    shrink_to_max_size();
-    // Extract timestamp.
-    using namespace std::chrono;
-    auto secs = seconds(header->ts.tv_sec);
-    auto ts = time{duration_cast<duration>(secs)};
-#ifdef PCAP_TSTAMP_PRECISION_NANO
-    ts += nanoseconds(header->ts.tv_usec);
-#else
-    ts += microseconds(header->ts.tv_usec);
-#endif
-    // Assemble packet.
-    auto layer3_ptr = reinterpret_cast<const char*>(layer3.data());
-    auto packet = std::string_view{std::launder(layer3_ptr), layer3.size()};
-    auto& cid = state(conn).community_id;
-    if (!(builder_->add(ts) && builder_->add(conn.src_addr)
-          && builder_->add(conn.dst_addr) && builder_->add(conn.src_port)
-          && builder_->add(conn.dst_port)
-          && (!community_id_ || builder_->add(std::string_view{cid}))
-          && builder_->add(packet))) {
-      return make_error(ec::parse_error, "unable to fill row");
-    }
+    if (auto err = add(p, st->community_id))
+      return err;
     ++produced;
     if (pseudo_realtime_ > 0) {
-      if (ts < last_timestamp_) {
+      if (p.ts < last_timestamp_) {
         VAST_WARNING(this, "encountered non-monotonic packet timestamps:",
-                     ts.time_since_epoch().count(), '<',
+                     p.ts.time_since_epoch().count(), '<',
                      last_timestamp_.time_since_epoch().count());
       }
       if (last_timestamp_ != time::min()) {
-        auto delta = ts - last_timestamp_;
+        auto delta = p.ts - last_timestamp_;
         std::this_thread::sleep_for(delta / pseudo_realtime_);
       }
-      last_timestamp_ = ts;
+      last_timestamp_ = p.ts;
     }
     if (builder_->rows() == max_slice_size)
       if (auto err = finish(f, caf::none))
@@ -421,7 +359,305 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
   return finish(f, caf::none);
 }
 
-reader::flow_state& reader::state(const flow& x) {
+caf::error reader::read_parallel(size_t max_events, size_t max_slice_size,
+                                 consumer& f) {
+  // Collect a chunk of packets first. libpcap reuses its buffer for the next
+  // packet, so we copy the network layer of every packet.
+  auto start = std::chrono::steady_clock::now();
+  auto result = caf::error{};
+  size_t num_packets = 0;
+  for (auto& indexes : shard_packets_)
+    indexes.clear();
+  while (num_packets < max_events) {
+    if (start + read_timeout_ < std::chrono::steady_clock::now()
+        && num_packets > 0) {
+      VAST_DEBUG(this, "reached input timeout");
+      result = ec::timeout;
+      break;
+    }
+    const u_char* data;
+    pcap_pkthdr* header;
+    auto r = ::pcap_next_ex(pcap_, &header, &data);
+    if (r == 0 && num_packets == 0)
+      continue; // timed out, no packets read yet
+    if (r == 0)
+      break; // timed out
+    if (r == -2) {
+      result = make_error(ec::end_of_input, "reached end of trace");
+      break;
+    }
+    if (r == -1) {
+      auto err = std::string{::pcap_geterr(pcap_)};
+      ::pcap_close(pcap_);
+      pcap_ = nullptr;
+      result = make_error(ec::format_error, "failed to get next packet: ", err);
+      break;
+    }
+    if (chunk_.size() == num_packets)
+      chunk_.emplace_back();
+    auto& p = chunk_[num_packets];
+    auto is_ip = decode(*header, data, p);
+    if (!is_ip) {
+      result = std::move(is_ip.error());
+      break;
+    }
+    if (!*is_ip) {
+      ++discard_count_;
+      VAST_DEBUG(this, "skips non-IP packet");
+      continue;
+    }
+    // The view into the copy is only set once the chunk is complete, because
+    // growing the chunk may move the copy.
+    p.buffer.assign(p.layer3.data(), p.layer3.size());
+    p.layer3 = {};
+    // Combine the hashes of both directions such that a connection always
+    // ends up in the same shard.
+    auto reverse = flow{p.conn.dst_addr, p.conn.src_addr, p.conn.dst_port,
+                        p.conn.src_port};
+    p.shard = (std::hash<flow>{}(p.conn) ^ std::hash<flow>{}(reverse))
+              % flows_.size();
+    shard_packets_[p.shard].push_back(num_packets);
+    ++num_packets;
+  }
+  // Track the flows of every shard on the worker pool. Every shard only visits
+  // its own packets, in input order.
+  workers_->run(flows_.size(), [this](size_t shard) {
+    for (auto i : shard_packets_[shard]) {
+      auto& p = chunk_[i];
+      auto st = flows_[shard].update(p.conn, p.packet_time, p.payload_size);
+      p.keep = st != nullptr;
+      if (p.keep && community_id_)
+        p.community_id = st->community_id;
+    }
+  });
+  // Add the packets in input order.
+  size_t produced = 0;
+  for (size_t i = 0; i < num_packets; ++i) {
+    auto& p = chunk_[i];
+    if (!p.keep) {
+      ++discard_count_;
+      VAST_DEBUG(this, "skips cut off packet");
+      continue;
+    }
+    p.layer3 = p.buffer;
+    if (auto err = add(p, p.community_id))
+      return err;
+    ++produced;
+    if (builder_->rows() == max_slice_size)
+      if (auto err = finish(f, caf::none))
+        return err;
+  }
+  // See read_impl for why we only report a timeout after producing events.
+  if (result == ec::timeout && produced == 0)
+    return finish(f, caf::none);
+  return finish(f, std::move(result));
+}
+
+caf::error reader::open_live() {
+  char buf[PCAP_ERRBUF_SIZE];
+  pcap_ = ::pcap_create(interface_->c_str(), buf);
+  if (!pcap_)
+    return make_error(ec::format_error, "failed to open interface",
+                      *interface_, ":", buf);
+  auto fail = [&](const char* what, std::string err) {
+    ::pcap_close(pcap_);
+    pcap_ = nullptr;
+    return make_error(ec::format_error, what, *interface_, ":", err);
+  };
+  // The setters of libpcap take an int and only fail with a status code, but
+  // may leave a more detailed message behind.
+  auto set = [&](const char* what, auto setter, size_t value) -> caf::error {
+    if (value > static_cast<size_t>(std::numeric_limits<int>::max()))
+      return fail(what, "value out of range: " + std::to_string(value));
+    if (auto status = setter(pcap_, static_cast<int>(value)); status != 0) {
+      auto err = std::string{::pcap_geterr(pcap_)};
+      return fail(what, err.empty() ? ::pcap_statustostr(status) : err);
+    }
+    return caf::none;
+  };
+  if (auto err = set("failed to set snaplen on interface", ::pcap_set_snaplen,
+                     snaplen_))
+    return err;
+  if (auto err = set("failed to enable promiscuous mode on interface",
+                     ::pcap_set_promisc, 1))
+    return err;
+  if (auto err = set("failed to set timeout on interface", ::pcap_set_timeout,
+                     1000))
+    return err;
+  // On Linux, libpcap captures into a memory-mapped TPACKET_V3 ring buffer of
+  // this size, from which it hands out packets without copying them.
+  if (buffer_size_ > 0)
+    if (auto err = set("failed to set buffer size on interface",
+                       ::pcap_set_buffer_size, buffer_size_))
+      return err;
+  auto status = ::pcap_activate(pcap_);
+  if (status < 0)
+    return fail("failed to activate interface",
+                std::string{::pcap_geterr(pcap_)});
+  if (status > 0)
+    VAST_WARNING(this, "activated interface with warning:",
+                 ::pcap_statustostr(status));
+  if (fanout_group_) {
+#if VAST_LINUX
+    // Let the kernel distribute packets by flow hash over all sockets in the
+    // same fanout group, e.g., over several sources capturing on the same
+    // interface. Reassembling fragments first keeps them in the same socket.
+    int arg = *fanout_group_
+              | ((PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG) << 16);
+    if (::setsockopt(::pcap_fileno(pcap_), SOL_PACKET, PACKET_FANOUT, &arg,
+                     sizeof(arg))
+        != 0) {
+      auto err = std::string{std::strerror(errno)};
+      ::pcap_close(pcap_);
+      pcap_ = nullptr;
+      return make_error(ec::format_error, "failed to join fanout group",
+                        *fanout_group_, ":", err);
+    }
+    VAST_INFO(this, "joins fanout group", *fanout_group_);
+#else
+    VAST_WARNING(this, "ignores fanout group on this platform");
+#endif
+  }
+  return caf::none;
+}
+
+caf::expected<bool>
+reader::decode(const pcap_pkthdr& header, const u_char* data, packet& result) {
+  // Parse frame.
+  span<const byte> frame{reinterpret_cast<const byte*>(data), header.len};
+  frame = decapsulate(frame, frame_type::ethernet);
+  if (frame.empty())
+    return make_error(ec::format_error, "failed to decapsulate frame");
+  constexpr size_t ethernet_header_size = 14;
+  auto layer3 = frame.subspan<ethernet_header_size>();
+  span<const byte> layer4;
+  uint8_t layer4_proto = 0;
+  auto& conn = result.conn;
+  conn = {};
+  // Parse layer 3.
+  switch (as_ether_type(frame.subspan<12, 2>())) {
+    default:
+      return false;
+    case ether_type::ipv4: {
+      constexpr size_t ipv4_header_size = 20;
+      if (header.len < ethernet_header_size + ipv4_header_size)
+        return make_error(ec::format_error, "IPv4 header too short");
+      size_t header_size = (to_integer<uint8_t>(layer3[0]) & 0x0f) * 4;
+      if (header_size < ipv4_header_size)
+        return make_error(ec::format_error,
+                          "IPv4 header too short: ", header_size, " bytes");
+      auto orig_h
+        = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 12));
+      auto resp_h
+        = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 16));
+      conn.src_addr = {orig_h, address::ipv4, address::network};
+      conn.dst_addr = {resp_h, address::ipv4, address::network};
+      layer4_proto = to_integer<uint8_t>(layer3[9]);
+      layer4 = layer3.subspan(header_size);
+      break;
+    }
+    case ether_type::ipv6: {
+      if (header.len < ethernet_header_size + 40)
+        return make_error(ec::format_error, "IPv6 header too short");
+      auto orig_h
+        = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 8));
+      auto resp_h
+        = reinterpret_cast<const uint32_t*>(std::launder(layer3.data() + 24));
+      conn.src_addr = {orig_h, address::ipv4, address::network};
+      conn.dst_addr = {resp_h, address::ipv4, address::network};
+      layer4_proto = to_integer<uint8_t>(layer3[6]);
+      layer4 = layer3.subspan(40);
+      break;
+    }
+  }
+  // Parse layer 4.
+  auto payload_size = layer4.size();
+  if (layer4_proto == IPPROTO_TCP) {
+    VAST_ASSERT(!layer4.empty());
+    auto orig_p
+      = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data()));
+    auto resp_p
+      = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data() + 2));
+    orig_p = detail::to_host_order(orig_p);
+    resp_p = detail::to_host_order(resp_p);
+    conn.src_port = {orig_p, port::tcp};
+    conn.dst_port = {resp_p, port::tcp};
+    auto data_offset
+      = *reinterpret_cast<const uint8_t*>(std::launder(layer4.data() + 12))
+        >> 4;
+    payload_size -= data_offset * 4;
+  } else if (layer4_proto == IPPROTO_UDP) {
+    VAST_ASSERT(!layer4.empty());
+    auto orig_p
+      = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data()));
+    auto resp_p
+      = *reinterpret_cast<const uint16_t*>(std::launder(layer4.data() + 2));
+    orig_p = detail::to_host_order(orig_p);
+    resp_p = detail::to_host_order(resp_p);
+    conn.src_port = {orig_p, port::udp};
+    conn.dst_port = {resp_p, port::udp};
+    payload_size -= 8;
+  } else if (layer4_proto == IPPROTO_ICMP) {
+    VAST_ASSERT(!layer4.empty());
+    auto message_type = to_integer<uint8_t>(layer4[0]);
+    auto message_code = to_integer<uint8_t>(layer4[1]);
+    conn.src_port = {message_type, port::icmp};
+    conn.dst_port = {message_code, port::icmp};
+    payload_size -= 8; // TODO: account for variable-size data.
+  }
+  result.payload_size = payload_size;
+  // Parse packet timestamp
+  result.packet_time = header.ts.tv_sec;
+  // Extract timestamp.
+  using namespace std::chrono;
+  auto secs = seconds(header.ts.tv_sec);
+  result.ts = time{duration_cast<duration>(secs)};
+#ifdef PCAP_TSTAMP_PRECISION_NANO
+  result.ts += nanoseconds(header.ts.tv_usec);
+#else
+  result.ts += microseconds(header.ts.tv_usec);
+#endif
+  auto layer3_ptr = reinterpret_cast<const char*>(layer3.data());
+  result.layer3 = std::string_view{std::launder(layer3_ptr), layer3.size()};
+  return true;
+}
+
+caf::error reader::add(const packet& x, std::string_view community_id) {
+  if (!(builder_->add(x.ts) && builder_->add(x.conn.src_addr)
+        && builder_->add(x.conn.dst_addr) && builder_->add(x.conn.src_port)
+        && builder_->add(x.conn.dst_port)
+        && (!community_id_ || builder_->add(community_id))
+        && builder_->add(x.layer3)))
+    return make_error(ec::parse_error, "unable to fill row");
+  return caf::none;
+}
+
+reader::flow_table::flow_table(uint64_t cutoff, size_t max_flows,
+                               uint64_t max_age, uint64_t expire_interval)
+  : cutoff_{cutoff},
+    max_flows_{max_flows},
+    max_age_{max_age},
+    expire_interval_{expire_interval} {
+  // nop
+}
+
+const reader::flow_state*
+reader::flow_table::update(const flow& x, uint64_t packet_time,
+                           uint64_t payload_size) {
+  if (last_expire_ == 0)
+    last_expire_ = packet_time;
+  if (!update_flow(x, packet_time, payload_size))
+    return nullptr;
+  evict_inactive(packet_time);
+  shrink_to_max_size();
+  return &state(x);
+}
+
+void reader::flow_table::clear() {
+  flows_.clear();
+}
+
+reader::flow_state& reader::flow_table::state(const flow& x) {
   auto i = flows_.find(x);
   if (i == flows_.end()) {
     auto cf = flow{x.src_addr, x.dst_addr, x.src_port, x.dst_port};
@@ -431,8 +667,8 @@ reader::flow_state& reader::state(const flow& x) {
   return i->second;
 }
 
-bool reader::update_flow(const flow& x, uint64_t packet_time,
-                         uint64_t payload_size) {
+bool reader::flow_table::update_flow(const flow& x, uint64_t packet_time,
+                                     uint64_t payload_size) {
   auto& st = state(x);
   st.last = packet_time;
   auto& flow_size = st.bytes;
@@ -444,7 +680,7 @@ bool reader::update_flow(const flow& x, uint64_t packet_time,
   return true;
 }
 
-void reader::evict_inactive(uint64_t packet_time) {
+void reader::flow_table::evict_inactive(uint64_t packet_time) {
   if (packet_time - last_expire_ <= expire_interval_)
     return;
   last_expire_ = packet_time;
@@ -456,7 +692,7 @@ void reader::evict_inactive(uint64_t packet_time) {
       ++i;
 }
 
-void reader::shrink_to_max_size() {
+void reader::flow_table::shrink_to_max_size() {
   while (flows_.size() >= max_flows_) {
     auto buckets = flows_.bucket_count();
     auto unif1 = std::uniform_int_distribution<size_t>{0, buckets - 1};
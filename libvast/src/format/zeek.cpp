@@ -36,6 +36,7 @@
 #include <caf/none.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 
@@ -204,6 +205,28 @@ void add_hash_index_attribute(record_type& layout) {
   }
 }
 
+// Splits a line into its fields without allocating once *fields* has grown to
+// the number of columns. Zeek almost always uses a single-character separator,
+// for which std::string_view::find reduces to a memchr-style scan. Like
+// detail::split, this omits an empty field after a trailing separator.
+void split_fields(std::string_view line, std::string_view separator,
+                  std::vector<std::string_view>& fields) {
+  VAST_ASSERT(!separator.empty());
+  fields.clear();
+  size_t first = 0;
+  auto next = [&](size_t pos) {
+    return separator.size() == 1 ? line.find(separator[0], pos)
+                                 : line.find(separator, pos);
+  };
+  for (auto last = next(first); last != std::string_view::npos;
+       last = next(first)) {
+    fields.push_back(line.substr(first, last - first));
+    first = last + separator.size();
+  }
+  if (first < line.size())
+    fields.push_back(line.substr(first));
+}
+
 } // namespace
 
 reader::reader(caf::atom_value table_slice_type, const caf::settings& options,
@@ -293,8 +316,6 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
     if (lines_->done())
       return make_error(ec::end_of_input, "input exhausted");
   }
-  // Local buffer for parsing records.
-  std::vector<data> xs;
   // Counts successfully parsed records.
   size_t produced = 0;
   auto next_line = [&, start = std::chrono::steady_clock::now()] {
@@ -321,7 +342,7 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       return finish(f, ec::timeout);
     }
     // Parse curent line.
-    auto& line = lines_->get();
+    auto line = lines_->view();
     if (line.empty()) {
       // Ignore empty lines.
       VAST_DEBUG(this, "ignores empty line at", lines_->line_number());
@@ -342,7 +363,8 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
       // Ignore comments.
       VAST_DEBUG(this, "ignores comment at line", lines_->line_number());
     } else {
-      auto fields = detail::split(lines_->get(), separator_);
+      split_fields(line, separator_, fields_);
+      auto& fields = fields_;
       if (fields.size() != parsers_.size()) {
         VAST_WARNING(this, "ignores invalid record at line",
                      lines_->line_number(), ':', "got", fields.size(),
@@ -358,6 +380,7 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
         return std::equal(empty_field_.begin(), empty_field_.end(),
                           fields[i].begin(), fields[i].end());
       };
+      auto& xs = values_;
       xs.resize(fields.size());
       for (size_t i = 0; i < fields.size(); ++i) {
         if (is_unset(i))
@@ -369,7 +392,8 @@ caf::error reader::read_impl(size_t max_events, size_t max_slice_size,
                                         lines_->line_number(),
                                         std::string{fields[i]}));
       }
-      patch(xs);
+      if (!port_fields_.empty())
+        patch(xs);
       for (size_t i = 0; i < fields.size(); ++i) {
         if (!builder_->add(make_data_view(xs[i])))
           return finish(f, make_error(ec::type_clash, "field", i, "line",
@@ -595,16 +619,21 @@ public:
   }
 
   bool operator()(Iterator& out, const view<std::string>& str) const {
-    for (auto c : str)
-      if (std::iscntrl(c) || c == separator || c == set_separator) {
-        auto hex = detail::byte_to_hex(c);
-        *out++ = '\\';
-        *out++ = 'x';
-        *out++ = hex.first;
-        *out++ = hex.second;
-      } else {
-        *out++ = c;
-      }
+    // The separator is a tab, which counts as a control character.
+    auto f = str.data();
+    auto l = f + str.size();
+    while (f != l) {
+      auto i = detail::find_control_or<set_separator>(f, l);
+      out = std::copy(f, i, out);
+      if (i == l)
+        break;
+      auto hex = detail::byte_to_hex(*i);
+      *out++ = '\\';
+      *out++ = 'x';
+      *out++ = hex.first;
+      *out++ = hex.second;
+      f = i + 1;
+    }
     return true;
   }
 
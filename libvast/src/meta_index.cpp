@@ -120,24 +120,26 @@ std::vector<uuid> meta_index::lookup(const expression& expr) const {
         VAST_ASSERT(caf::holds_alternative<data>(x.rhs));
         auto& rhs = caf::get<data>(x.rhs);
         result_type result;
-        auto found_matching_synopsis = false;
+        auto found_matching_field = false;
         for (auto& [part_id, part_syn] : synopses_) {
           VAST_DEBUG(this, "checks", part_id, "for predicate", x);
           for (auto& [field, syn] : part_syn) {
-            if (syn && match(field)) {
-              found_matching_synopsis = true;
-              auto opt = syn->lookup(x.op, make_view(rhs));
-              if (!opt || *opt) {
-                VAST_DEBUG(this, "selects", part_id, "at predicate", x);
-                result.push_back(part_id);
-                break;
-              }
+            if (!match(field))
+              continue;
+            found_matching_field = true;
+            // A field without synopsis cannot rule out the partition.
+            auto opt = syn ? syn->lookup(x.op, make_view(rhs))
+                           : caf::optional<bool>{};
+            if (!opt || *opt) {
+              VAST_DEBUG(this, "selects", part_id, "at predicate", x);
+              result.push_back(part_id);
+              break;
             }
           }
         }
         // Re-establish potentially violated invariant.
         std::sort(result.begin(), result.end());
-        return found_matching_synopsis ? result : all_partitions();
+        return found_matching_field ? result : all_partitions();
       };
       auto extract_expr = detail::overload(
         [&](const attribute_extractor& lhs, const data& d) -> result_type {
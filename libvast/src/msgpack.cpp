@@ -128,7 +128,7 @@ size_t overlay::next() {
 }
 
 size_t overlay::next(size_t n) {
-  auto result = 0;
+  size_t result = 0;
   for (size_t i = 0; i < n; ++i) {
     auto n = next();
     VAST_ASSERT(n > 0);
@@ -26,6 +26,7 @@
 #include <caf/serializer.hpp>
 #include <caf/streambuf.hpp>
 
+#include <limits>
 #include <type_traits>
 
 using namespace vast;
@@ -49,6 +50,7 @@ caf::error msgpack_table_slice::deserialize(caf::deserializer& source) {
   if (auto err = source(offset_table_, chunk_))
     return err;
   buffer_ = as_bytes(span{chunk_->data(), chunk_->size()});
+  index_cells();
   return caf::none;
 }
 
@@ -67,9 +69,27 @@ caf::error msgpack_table_slice::load(chunk_ptr chunk) {
   auto deserializer_position = chunk->size() - remaining_bytes;
   chunk_ = chunk->slice(deserializer_position + sizeof(uint32_t));
   buffer_ = as_bytes(span{chunk_->data(), chunk_->size()});
+  index_cells();
   return caf::none;
 }
 
+void msgpack_table_slice::index_cells() {
+  cell_offsets_.clear();
+  if (static_cast<size_t>(buffer_.size())
+      > std::numeric_limits<uint32_t>::max())
+    return;
+  cell_offsets_.reserve(rows() * columns());
+  for (auto offset : offset_table_) {
+    auto xs = msgpack::overlay{buffer_.subspan(offset)};
+    for (size_t col = 0; col < columns(); ++col) {
+      cell_offsets_.push_back(detail::narrow_cast<uint32_t>(offset));
+      auto n = xs.next();
+      VAST_ASSERT(n > 0);
+      offset += n;
+    }
+  }
+}
+
 namespace {
 
 class msgpack_array_view : public container_view<data_view>,
@@ -288,17 +308,11 @@ msgpack_map_view::value_type msgpack_map_view::at(size_type i) const {
 
 } // namespace
 
-// There are only small gains we can get here from doing this manually since
-// MsgPack is a row-oriented format.
 void msgpack_table_slice::append_column_to_index(size_type col,
                                                  value_index& idx) const {
-  for (size_t row = 0; row < rows(); ++row) {
-    auto row_offset = offset_table_[row];
-    auto xs = msgpack::overlay{buffer_.subspan(row_offset)};
-    xs.next(col);
-    auto x = decode(xs, layout().fields[col].type);
-    idx.append(x, offset() + row);
-  }
+  auto& t = layout().fields[col].type;
+  for (size_t row = 0; row < rows(); ++row)
+    idx.append(at(row, col, t), offset() + row);
 }
 
 caf::atom_value msgpack_table_slice::implementation_id() const noexcept {
@@ -306,14 +320,26 @@ caf::atom_value msgpack_table_slice::implementation_id() const noexcept {
 }
 
 data_view msgpack_table_slice::at(size_type row, size_type col) const {
-  // First find the desired row...
+  return at(row, col, layout().fields[col].type);
+}
+
+data_view msgpack_table_slice::at(size_type row, size_type col,
+                                  const type& t) const {
   VAST_ASSERT(row < offset_table_.size());
+  VAST_ASSERT(col < columns());
+  // Jump to the cell directly if possible.
+  if (!cell_offsets_.empty()) {
+    auto offset = cell_offsets_[row * columns() + col];
+    auto xs = msgpack::overlay{buffer_.subspan(offset)};
+    return decode(xs, t);
+  }
+  // Otherwise, find the desired row...
   auto offset = offset_table_[row];
   VAST_ASSERT(offset < static_cast<size_t>(buffer_.size()));
   auto xs = msgpack::overlay{buffer_.subspan(offset)};
   // ...then skip (decode) up to the desired column.
   xs.next(col);
-  return decode(xs, layout().fields[col].type);
+  return decode(xs, t);
 }
 
 } // namespace vast
@@ -130,6 +130,23 @@ bool msgpack_table_slice_builder::add_impl(data_view x) {
   return true;
 }
 
+bool msgpack_table_slice_builder::add_columns_impl(
+  const std::vector<column>& xs, size_t rows) {
+  if (col_ != 0)
+    return false;
+  offset_table_.reserve(offset_table_.size() + rows);
+  for (size_t row = 0; row < rows; ++row) {
+    offset_table_.push_back(buffer_.size());
+    for (auto& x : xs) {
+      auto encode_value = [&](auto ys) { return encode(builder_, ys[row]); };
+      auto n = x.is_nil(row) ? encode(builder_, caf::none)
+                             : caf::visit(encode_value, x.values);
+      VAST_ASSERT(n > 0);
+    }
+  }
+  return true;
+}
+
 table_slice_ptr msgpack_table_slice_builder::finish() {
   // Sanity check.
   if (col_ != 0)
@@ -141,6 +158,7 @@ table_slice_ptr msgpack_table_slice_builder::finish() {
   ptr->offset_table_ = std::move(offset_table_);
   ptr->chunk_ = chunk::make(std::move(buffer_));
   ptr->buffer_ = as_bytes(span{ptr->chunk_->data(), ptr->chunk_->size()});
+  ptr->index_cells();
   offset_table_ = {};
   buffer_ = {};
   return table_slice_ptr{ptr, false};
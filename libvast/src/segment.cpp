@@ -28,6 +28,7 @@
 
 #include <caf/binary_deserializer.hpp>
 #include <caf/binary_serializer.hpp>
+#include <caf/optional.hpp>
 
 namespace vast {
 
@@ -38,9 +39,13 @@ caf::expected<segment> segment::make(chunk_ptr chunk) {
   auto ptr = fbs::as_flatbuffer<fbs::Segment>(as_bytes(chunk));
   if (ptr == nullptr)
     return make_error(ec::format_error, "segment integrity check failed");
-  // Perform version check.
-  if (auto err = fbs::check_version(ptr->version(), fbs::Version::v0))
-    return err;
+  // Perform version check. Segments of version v0 contain the layout in every
+  // table slice.
+  if (ptr->version() != fbs::Version::v0)
+    if (auto err = fbs::check_version(ptr->version(), fbs::Version::v1))
+      return err;
+  if (ptr->version() == fbs::Version::v1 && ptr->layouts() == nullptr)
+    return make_error(ec::format_error, "segment has no layouts");
   return segment{std::move(chunk)};
 }
 
@@ -76,17 +81,45 @@ segment::lookup(const vast::ids& xs) const {
     auto slice = buffer->data_nested_root();
     return std::pair{slice->offset(), slice->offset() + slice->rows()};
   };
+  auto ptr = fbs::GetSegment(chunk_->data());
+  // Deserialize every layout at most once per lookup instead of once per
+  // table slice.
+  auto legacy = ptr->version() == fbs::Version::v0;
+  auto layouts = ptr->layouts();
+  std::vector<caf::optional<record_type>> cache;
+  if (!legacy)
+    cache.resize(layouts->size());
   auto g = [&](auto buffer) -> caf::error {
     // TODO: bind the lifetime of the table slice to the segment chunk. This
     // requires that table slices will be constructable from a chunk. Until
     // then, we stupidly deserialize the data into a new table slice.
+    auto flat_slice = buffer->data_nested_root();
     table_slice_ptr slice;
-    if (auto err = unpack(*buffer->data_nested_root(), slice))
+    if (legacy) {
+      if (auto err = unpack(*flat_slice, slice))
+        return err;
+      result.push_back(std::move(slice));
+      return caf::none;
+    }
+    auto layout_id = flat_slice->layout_id();
+    if (layout_id >= cache.size())
+      return make_error(ec::format_error, "invalid layout id", layout_id);
+    auto& layout = cache[layout_id];
+    if (!layout) {
+      layout = record_type{};
+      auto data = layouts->Get(layout_id)->data();
+      auto bytes = reinterpret_cast<const char*>(data->Data());
+      caf::binary_deserializer source{nullptr, bytes, data->size()};
+      if (auto err = source(*layout)) {
+        layout = caf::none;
+        return err;
+      }
+    }
+    if (auto err = unpack(*flat_slice, *layout, slice))
       return err;
     result.push_back(std::move(slice));
     return caf::none;
   };
-  auto ptr = fbs::GetSegment(chunk_->data());
   auto begin = ptr->slices()->begin();
   auto end = ptr->slices()->end();
   if (auto error = select_with(xs, begin, end, f, g))
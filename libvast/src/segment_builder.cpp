@@ -34,7 +34,23 @@ segment_builder::segment_builder() {
 caf::error segment_builder::add(table_slice_ptr x) {
   if (x->offset() < min_table_slice_offset_)
     return make_error(ec::unspecified, "slice offsets not increasing");
-  auto slice = pack(builder_, x);
+  // Store every distinct layout only once per segment.
+  auto [layout, inserted] = layout_ids_.try_emplace(
+    x->layout(), detail::narrow_cast<uint32_t>(flat_layouts_.size()));
+  if (inserted) {
+    std::vector<char> buffer;
+    caf::binary_serializer sink{nullptr, buffer};
+    if (auto error = sink(x->layout())) {
+      layout_ids_.erase(layout);
+      return error;
+    }
+    auto ptr = reinterpret_cast<const uint8_t*>(buffer.data());
+    auto data = builder_.CreateVector(ptr, buffer.size());
+    fbs::LayoutBufferBuilder layout_buffer_builder{builder_};
+    layout_buffer_builder.add_data(data);
+    flat_layouts_.push_back(layout_buffer_builder.Finish());
+  }
+  auto slice = pack(builder_, x, layout->second);
   if (!slice)
     return slice.error();
   flat_slices_.push_back(*slice);
@@ -53,12 +69,14 @@ segment segment_builder::finish() {
   auto table_slices_offset = builder_.CreateVector(flat_slices_);
   auto uuid_offset = fbs::pack_bytes(builder_, id_);
   auto ids_offset = builder_.CreateVectorOfStructs(intervals_);
+  auto layouts_offset = builder_.CreateVector(flat_layouts_);
   fbs::SegmentBuilder segment_builder{builder_};
-  segment_builder.add_version(fbs::Version::v0);
+  segment_builder.add_version(fbs::Version::v1);
   segment_builder.add_slices(table_slices_offset);
   segment_builder.add_uuid(uuid_offset);
   segment_builder.add_ids(ids_offset);
   segment_builder.add_events(num_events_);
+  segment_builder.add_layouts(layouts_offset);
   auto segment_offset = segment_builder.Finish();
   fbs::FinishSegmentBuffer(builder_, segment_offset);
   auto chk = fbs::release(builder_);
@@ -108,6 +126,8 @@ void segment_builder::reset() {
   num_events_ = 0;
   builder_.Clear();
   flat_slices_.clear();
+  flat_layouts_.clear();
+  layout_ids_.clear();
   intervals_.clear();
   slices_.clear();
 }
@@ -157,11 +157,9 @@ auto make_export_command() {
                           documentation::vast_export_null,
                           sink_opts("?export.null"));
 #if VAST_HAVE_ARROW
-  // The Arrow export does not support --write or --uds, so we don't use the
-  // sink_opts here intentionally.
   export_->add_subcommand("arrow", "exports query results in Arrow format",
                           documentation::vast_export_arrow,
-                          opts("?export.arrow"));
+                          sink_opts("?export.arrow"));
 
 #endif
 #if VAST_HAVE_PCAP
@@ -187,8 +185,12 @@ auto make_import_command() {
       .add<caf::atom_value>("batch-encoding", "encoding type of table slices "
                                               "(arrow or msgpack)")
       .add<size_t>("batch-size", "upper bound for the size of a table slice")
+      .add<size_t>("min-batch-size", "lower bound for the size of a table "
+                                     "slice, which enables adaptive sizing")
       .add<std::string>("batch-timeout", "timoeut after which batched table "
                                          "slices are forwarded")
+      .add<size_t>("parse-threads", "number of threads for parsing JSON "
+                                    "and PCAP input (0 for all cores)")
       .add<bool>("blocking,b", "block until the IMPORTER forwarded all data")
       .add<size_t>("max-events,n", "the maximum number of events to "
                                    "import"));
@@ -224,6 +226,10 @@ auto make_import_command() {
       .add<size_t>("pseudo-realtime-factor,p", "factor c delaying packets by "
                                                "1/c")
       .add<size_t>("snaplen", "snapshot length in bytes")
+      .add<size_t>("buffer-size", "kernel capture buffer size in bytes for "
+                                  "live capture")
+      .add<size_t>("fanout-group", "PACKET_FANOUT group to share the "
+                                   "interface with other sources (Linux)")
       .add<double>("drop-rate-threshold", "drop rate that must be exceeded for "
                                           "warnings to occur")
       .add<bool>("disable-community-id", "disable computation of community id "
@@ -264,6 +270,8 @@ auto make_spawn_source_command() {
       .add<caf::atom_value>("batch-encoding", "encoding type of table slices "
                                               "(arrow or msgpack)")
       .add<size_t>("batch-size", "upper bound for the size of a table slice")
+      .add<size_t>("min-batch-size", "lower bound for the size of a table "
+                                     "slice, which enables adaptive sizing")
       .add<std::string>("batch-timeout", "timoeut after which batched table "
                                          "slices are forwarded")
       .add<size_t>("max-events,n", "the maximum number of events to "
@@ -289,6 +297,10 @@ auto make_spawn_source_command() {
       .add<size_t>("pseudo-realtime-factor,p", "factor c delaying packets by "
                                                "1/c")
       .add<size_t>("snaplen", "snapshot length in bytes")
+      .add<size_t>("buffer-size", "kernel capture buffer size in bytes for "
+                                  "live capture")
+      .add<size_t>("fanout-group", "PACKET_FANOUT group to share the "
+                                   "interface with other sources (Linux)")
       .add<double>("drop-rate-threshold", "drop rate that must be exceeded for "
                                           "warnings to occur")
       .add<bool>("disable-community-id", "disable computation of community id "
@@ -0,0 +1,73 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#include "vast/system/batch_size_controller.hpp"
+
+#include "vast/detail/assert.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace vast::system {
+
+namespace {
+
+/// The weight of a new observation in the smoothed event rate.
+constexpr double rate_smoothing = 0.25;
+
+} // namespace
+
+batch_size_controller::batch_size_controller(size_t size)
+  : min_size_{size}, max_size_{size}, size_{size}, target_latency_{} {
+  // nop
+}
+
+batch_size_controller::batch_size_controller(size_t min_size, size_t max_size,
+                                             duration target_latency)
+  : min_size_{min_size},
+    max_size_{max_size},
+    size_{min_size},
+    target_latency_{target_latency} {
+  VAST_ASSERT(min_size_ > 0);
+  VAST_ASSERT(min_size_ <= max_size_);
+}
+
+void batch_size_controller::observe(uint64_t events, duration elapsed,
+                                    size_t credit, bool timed_out) {
+  if (!adaptive())
+    return;
+  using fractional_seconds = std::chrono::duration<double>;
+  auto seconds = std::chrono::duration_cast<fractional_seconds>(elapsed);
+  if (events > 0 && seconds.count() > 0) {
+    auto rate = events / seconds.count();
+    rate_ = rate_ == 0.0 ? rate : rate_ + rate_smoothing * (rate - rate_);
+  }
+  // Aim for table slices that fill up within the target latency. Since the
+  // elapsed time includes waiting for input, this shrinks slices for sources
+  // that receive few events and grows them for sources that are bound by
+  // parsing.
+  auto latency = std::chrono::duration_cast<fractional_seconds>(target_latency_);
+  auto target = rate_ * latency.count();
+  // If the sinks ask for at most one table slice while the input keeps up,
+  // they fall behind. Fewer but larger table slices reduce their per-slice
+  // overhead.
+  if (!timed_out && credit <= 1)
+    target = std::max(target, 2.0 * size_);
+  // Change the size by at most a factor of two per observation to dampen
+  // short bursts.
+  auto lower = std::max(static_cast<double>(min_size_), size_ / 2.0);
+  auto upper = std::min(static_cast<double>(max_size_), size_ * 2.0);
+  size_ = static_cast<size_t>(std::clamp(target, lower, upper));
+}
+
+} // namespace vast::system
@@ -54,7 +54,8 @@ void counter_state::init(expression expr, caf::actor index,
       if (it == checkers_.end()) {
         if (auto x = tailor(expr_, slice->layout())) {
           std::tie(it, std::ignore) = checkers_.emplace(
-            vast::record_type{slice->layout()}, std::move(*x));
+            vast::record_type{slice->layout()},
+            candidate_checker{*x, slice->layout()});
         } else {
           VAST_ERROR(self_, "failed to tailor expression:",
                      self_->system().render(x.error()));
@@ -62,7 +63,7 @@ void counter_state::init(expression expr, caf::actor index,
         }
       }
       // Perform the candidate check and count results.
-      auto num_results = rank(evaluate(it->second, *slice));
+      auto num_results = rank(it->second(*slice));
       if (num_results > 0)
         self_->send(client_, num_results);
     },
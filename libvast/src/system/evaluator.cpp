@@ -23,6 +23,9 @@
 #include <caf/event_based_actor.hpp>
 #include <caf/stateful_actor.hpp>
 
+#include <unordered_map>
+#include <vector>
+
 namespace vast::system {
 
 namespace {
@@ -130,6 +133,34 @@ void evaluator_state::handle_missing_result(const offset& position,
   decrement_pending();
 }
 
+void evaluator_state::handle_results(const std::vector<offset>& positions,
+                                     const std::vector<ids>& results,
+                                     const std::vector<caf::error>& errors) {
+  VAST_ASSERT(results.size() == positions.size());
+  VAST_ASSERT(errors.size() == positions.size());
+  auto complete = false;
+  for (size_t i = 0; i < positions.size(); ++i) {
+    auto ptr = hits_for(positions[i]);
+    VAST_ASSERT(ptr != nullptr);
+    auto& [missing, accumulated_hits] = *ptr;
+    if (errors[i])
+      VAST_WARNING(self, "INDEXER returned", self->system().render(errors[i]),
+                   "instead of a result for predicate at position",
+                   positions[i]);
+    else
+      accumulated_hits |= results[i];
+    if (--missing == 0) {
+      VAST_DEBUG(self, "collected all INDEXER results at position",
+                 positions[i]);
+      complete = true;
+    }
+  }
+  // Evaluating walks the entire expression, so we do it once for the batch.
+  if (complete)
+    evaluate();
+  decrement_pending(positions.size());
+}
+
 void evaluator_state::evaluate() {
   VAST_DEBUG(self, "got predicate_hits:", predicate_hits,
              "expr_hits:", caf::visit(ids_evaluator{predicate_hits}, expr));
@@ -140,9 +171,11 @@ void evaluator_state::evaluate() {
   }
 }
 
-void evaluator_state::decrement_pending() {
+void evaluator_state::decrement_pending(size_t n) {
+  VAST_ASSERT(pending_responses >= n);
   // We're done evaluating if all INDEXER actors have reported their hits.
-  if (--pending_responses == 0) {
+  pending_responses -= n;
+  if (pending_responses == 0) {
     VAST_DEBUG(self, "completed expression evaluation");
     promise.deliver(atom::done_v);
   }
@@ -164,6 +197,15 @@ caf::behavior evaluator(caf::stateful_actor<evaluator_state>* self,
     auto& st = self->state;
     st.init(client, move(expr), self->make_response_promise());
     st.pending_responses += eval.size();
+    // Group the predicates by INDEXER, such that each INDEXER receives all
+    // of its predicates in a single request.
+    struct batch {
+      caf::actor indexer;
+      std::vector<offset> positions;
+      std::vector<curried_predicate> predicates;
+    };
+    std::vector<batch> batches;
+    std::unordered_map<caf::actor, size_t> batch_index;
     for (auto& triple : eval) {
       // No strucutured bindings available due to subsequent lambda. :-/
       // TODO: C++20
@@ -171,11 +213,33 @@ caf::behavior evaluator(caf::stateful_actor<evaluator_state>* self,
       auto& curried_pred = get<1>(triple);
       auto& indexer = get<2>(triple);
       ++st.predicate_hits[pos].first;
-      self->request(indexer, caf::infinite, curried_pred)
-        .then([=](const ids& hits) { self->state.handle_result(pos, hits); },
-              [=](const caf::error& err) {
-                self->state.handle_missing_result(pos, err);
-              });
+      auto [i, added] = batch_index.emplace(indexer, batches.size());
+      if (added)
+        batches.push_back(batch{indexer, {}, {}});
+      batches[i->second].positions.push_back(pos);
+      batches[i->second].predicates.push_back(curried_pred);
+    }
+    for (auto& x : batches) {
+      if (x.predicates.size() == 1) {
+        auto pos = x.positions.front();
+        self->request(x.indexer, caf::infinite, move(x.predicates.front()))
+          .then([=](const ids& hits) { self->state.handle_result(pos, hits); },
+                [=](const caf::error& err) {
+                  self->state.handle_missing_result(pos, err);
+                });
+        continue;
+      }
+      self->request(x.indexer, caf::infinite, move(x.predicates))
+        .then(
+          [=, positions = x.positions](const std::vector<ids>& hits,
+                                       const std::vector<caf::error>& errors) {
+            self->state.handle_results(positions, hits, errors);
+          },
+          [=, positions = x.positions](const caf::error& err) {
+            auto hits = std::vector<ids>(positions.size());
+            auto errors = std::vector<caf::error>(positions.size(), err);
+            self->state.handle_results(positions, hits, errors);
+          });
     }
     if (st.pending_responses == 0) {
       VAST_DEBUG(self, "has nothing to evaluate for expression");
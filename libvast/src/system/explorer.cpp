@@ -13,6 +13,7 @@
 
 #include "vast/system/explorer.hpp"
 
+#include "vast/bitmap_algorithms.hpp"
 #include "vast/command.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/expression.hpp"
@@ -20,6 +21,7 @@
 #include "vast/detail/string.hpp"
 #include "vast/expression.hpp"
 #include "vast/fwd.hpp"
+#include "vast/ids.hpp"
 #include "vast/logger.hpp"
 #include "vast/system/exporter.hpp"
 #include "vast/table_slice.hpp"
@@ -30,7 +32,9 @@
 #include <caf/settings.hpp>
 
 #include <algorithm>
+#include <memory>
 #include <optional>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -80,6 +84,147 @@ void explorer_state::forward_results(vast::table_slice_ptr slice) {
   return;
 }
 
+namespace {
+
+// Finds the first column with the timestamp attribute.
+const record_field* timestamp_field(const record_type& layout) {
+  auto it = std::find_if(layout.fields.begin(), layout.fields.end(),
+                         [](const record_field& field) {
+                           return has_attribute(field.type, "timestamp");
+                         });
+  return it != layout.fields.end() ? &*it : nullptr;
+}
+
+bool earlier(const explorer_state::seed& x, const explorer_state::seed& y) {
+  return x.timestamp < y.timestamp;
+}
+
+} // namespace
+
+expression explorer_state::make_query(const seed_map& seeds) const {
+  VAST_ASSERT(!seeds.empty());
+  auto build_conjunction
+    = [](std::optional<expression>&& lhs,
+         std::optional<expression>&& rhs) -> std::optional<expression> {
+    if (lhs && rhs)
+      return conjunction{std::move(*lhs), std::move(*rhs)};
+    if (lhs)
+      return std::move(lhs);
+    if (rhs)
+      return std::move(rhs);
+    return std::nullopt;
+  };
+  auto make_timebox = [](vast::time first, vast::time last) -> expression {
+    return conjunction{predicate{attribute_extractor{atom::timestamp_v},
+                                 greater_equal, data{first}},
+                       predicate{attribute_extractor{atom::timestamp_v},
+                                 less_equal, data{last}}};
+  };
+  // Merge overlapping time boxes into one disjunction. Either both 'before'
+  // and 'after' are set, or none of them.
+  std::optional<expression> temporal_expr;
+  if (before) {
+    VAST_ASSERT(after);
+    std::vector<vast::time> timestamps;
+    for (auto& [_, xs] : seeds)
+      for (auto& x : xs)
+        timestamps.push_back(x.timestamp);
+    std::sort(timestamps.begin(), timestamps.end());
+    disjunction timeboxes;
+    auto first = timestamps.front() - *before;
+    auto last = timestamps.front() + *after;
+    for (auto x : timestamps) {
+      if (x - *before > last) {
+        timeboxes.push_back(make_timebox(first, last));
+        first = x - *before;
+      }
+      last = std::max(last, x + *after);
+    }
+    timeboxes.push_back(make_timebox(first, last));
+    if (timeboxes.size() == 1)
+      temporal_expr = std::move(timeboxes.front());
+    else
+      temporal_expr = std::move(timeboxes);
+  }
+  std::optional<expression> spatial_expr;
+  if (by) {
+    list values;
+    values.reserve(seeds.size());
+    for (auto& [value, _] : seeds)
+      values.push_back(value);
+    if (values.size() == 1)
+      spatial_expr = predicate{field_extractor{*by}, equal,
+                               std::move(values.front())};
+    else
+      spatial_expr = predicate{field_extractor{*by}, in, data{std::move(values)}};
+  }
+  auto expr
+    = build_conjunction(std::move(temporal_expr), std::move(spatial_expr));
+  // We should have checked during argument parsing that `expr` has at
+  // least one constraint.
+  VAST_ASSERT(expr);
+  return std::move(*expr);
+}
+
+void explorer_state::forward_context(seed_map& seeds,
+                                     vast::table_slice_ptr slice) {
+  std::optional<table_slice::column_view> time_column;
+  if (before) {
+    if (auto field = timestamp_field(slice->layout()))
+      if (auto column = slice->column(field->name))
+        time_column.emplace(*column);
+    if (!time_column)
+      return;
+  }
+  std::optional<table_slice::column_view> by_column;
+  if (by) {
+    if (auto column = slice->column(*by))
+      by_column.emplace(*column);
+    if (!by_column)
+      return;
+  }
+  // A row is selected if it lies in the time box of at least one seed with
+  // the same value of the `by` field that has not reached its limit yet. All
+  // of these seeds account for the row, just as if there were one query per
+  // seed.
+  vast::ids selection;
+  selection.append_bits(false, slice->offset());
+  for (size_t row = 0; row < slice->rows(); ++row) {
+    auto selected = false;
+    auto group = seeds.find(by_column ? materialize((*by_column)[row]) : data{});
+    if (group != seeds.end()) {
+      auto& xs = group->second;
+      auto first = xs.begin();
+      auto last = xs.end();
+      if (time_column) {
+        auto value = (*time_column)[row];
+        if (auto x = caf::get_if<vast::time>(&value)) {
+          first = std::lower_bound(first, last, seed{*x - *after}, earlier);
+          last = std::upper_bound(first, last, seed{*x + *before}, earlier);
+        } else {
+          first = last;
+        }
+      }
+      for (auto i = first; i != last; ++i) {
+        if (limits.per_result == 0 || i->num_results < limits.per_result) {
+          ++i->num_results;
+          selected = true;
+        }
+      }
+    }
+    selection.append_bit(selected);
+  }
+  auto selected = rank(selection);
+  if (selected == 0)
+    return;
+  if (selected == slice->rows()) {
+    forward_results(std::move(slice));
+    return;
+  }
+  for (auto& x : vast::select(slice, selection))
+    forward_results(std::move(x));
+}
+
 caf::behavior
 explorer(caf::stateful_actor<explorer_state>* self, caf::actor node,
          explorer_state::event_limits limits,
@@ -108,6 +253,7 @@ explorer(caf::stateful_actor<explorer_state>* self, caf::actor node,
   self->set_down_handler([=]([[maybe_unused]] const caf::down_msg& msg) {
     // Only the spawned EXPORTERs are expected to send down messages.
     auto& st = self->state;
+    st.queries.erase(msg.source);
     --st.running_exporters;
     VAST_DEBUG(self, "received DOWN from", msg.source,
                "outstanding requests:", st.running_exporters);
@@ -119,18 +265,17 @@ explorer(caf::stateful_actor<explorer_state>* self, caf::actor node,
       // TODO: Add some cleaner way to distinguish the different input streams,
       // maybe some 'tagged' stream in caf?
       if (self->current_sender() != st.initial_query_exporter) {
-        st.forward_results(slice);
+        auto sender = caf::actor_cast<caf::actor_addr>(self->current_sender());
+        if (auto i = st.queries.find(sender); i != st.queries.end())
+          st.forward_context(i->second, std::move(slice));
         return;
       }
       // Don't bother making new queries if we discard all results anyways.
       if (st.num_sent >= st.limits.total)
         return;
       auto& layout = slice->layout();
-      auto it = std::find_if(layout.fields.begin(), layout.fields.end(),
-                             [](const record_field& field) {
-                               return has_attribute(field.type, "timestamp");
-                             });
-      if (it == layout.fields.end()) {
+      auto field = timestamp_field(layout);
+      if (!field) {
         VAST_DEBUG(self, "could not find timestamp field in", layout);
         return;
       }
@@ -146,72 +291,58 @@ explorer(caf::stateful_actor<explorer_state>* self, caf::actor node,
           return;
         }
       }
-      VAST_DEBUG(self, "uses", it->name, "to construct timebox");
-      auto column = slice->column(it->name);
+      VAST_DEBUG(self, "uses", field->name, "to construct timebox");
+      auto column = slice->column(field->name);
       VAST_ASSERT(column);
+      // Collect the seeds of all rows, such that a single query covers the
+      // context of the entire slice.
+      explorer_state::seed_map seeds;
       for (size_t i = 0; i < column->rows(); ++i) {
         auto data_view = (*column)[i];
         auto x = caf::get_if<vast::time>(&data_view);
         // Skip if no value
         if (!x)
           continue;
-        std::optional<vast::expression> before_expr;
-        if (st.before)
-          before_expr = predicate{attribute_extractor{atom::timestamp_v},
-                                  greater_equal, data{*x - *st.before}};
-
-        std::optional<vast::expression> after_expr;
-        if (st.after)
-          after_expr = predicate{attribute_extractor{atom::timestamp_v},
-                                 less_equal, data{*x + *st.after}};
-        std::optional<vast::expression> by_expr;
+        data key;
         if (st.by) {
           VAST_ASSERT(by_column); // Should have been checked above.
           auto ci = (*by_column)[i];
           if (caf::get_if<caf::none_t>(&ci))
             continue;
-          // TODO: Make `predicate` accept a data_view as well to save
-          // the call to `materialize()`.
-          by_expr = predicate{field_extractor{*st.by}, equal, materialize(ci)};
+          key = materialize(ci);
         }
-        auto build_conjunction
-          = [](std::optional<expression>&& lhs,
-               std::optional<expression>&& rhs) -> std::optional<expression> {
-          if (lhs && rhs)
-            return conjunction{std::move(*lhs), std::move(*rhs)};
-          if (lhs)
-            return std::move(lhs);
-          if (rhs)
-            return std::move(rhs);
-          return std::nullopt;
-        };
-        auto temporal_expr
-          = build_conjunction(std::move(before_expr), std::move(after_expr));
-        auto spatial_expr = std::move(by_expr);
-        auto expr = build_conjunction(std::move(temporal_expr),
-                                      std::move(spatial_expr));
-        // We should have checked during argument parsing that `expr` has at
-        // least one constraint.
-        VAST_ASSERT(expr);
-        auto query = to_string(*expr);
-        VAST_TRACE(self, "spawns new exporter with query", query);
-        auto exporter_invocation = invocation{{}, "spawn exporter", {query}};
-        if (st.limits.per_result)
-          caf::put(exporter_invocation.options, "export.max-events",
-                   st.limits.per_result);
-        self->send(st.node, exporter_invocation);
-        ++st.running_exporters;
+        seeds[std::move(key)].push_back({*x});
       }
+      if (seeds.empty())
+        return;
+      for (auto& [_, xs] : seeds)
+        std::sort(xs.begin(), xs.end(), earlier);
+      auto query = to_string(st.make_query(seeds));
+      VAST_TRACE(self, "spawns new exporter with query", query);
+      auto exporter_invocation = invocation{{}, "spawn exporter", {query}};
+      ++st.running_exporters;
+      auto pending = std::make_shared<explorer_state::seed_map>(
+        std::move(seeds));
+      self->request(st.node, caf::infinite, exporter_invocation)
+        .then(
+          [=](caf::actor exp) {
+            VAST_DEBUG(self, "registers exporter", exp);
+            auto& st = self->state;
+            st.queries.emplace(exp.address(), std::move(*pending));
+            self->monitor(exp);
+            self->send(exp, atom::sink_v, self);
+            self->send(exp, atom::run_v);
+          },
+          [=](const caf::error& err) {
+            VAST_ERROR(self, "failed to spawn exporter for query", query, ":",
+                       self->system().render(err));
+            --self->state.running_exporters;
+            quit_if_done();
+          });
     },
     [=](atom::provision, caf::actor exp) {
       self->state.initial_query_exporter = exp;
     },
-    [=](caf::actor exp) {
-      VAST_DEBUG(self, "registers exporter", exp);
-      self->monitor(exp);
-      self->send(exp, atom::sink_v, self);
-      self->send(exp, atom::run_v);
-    },
     [=]([[maybe_unused]] std::string name, query_status) {
       VAST_DEBUG(self, "received final status from", name);
       self->state.initial_query_completed = true;
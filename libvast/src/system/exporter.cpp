@@ -220,12 +220,12 @@ behavior exporter(stateful_actor<exporter_state>* self, expression expr,
         return;
       }
       VAST_DEBUG(self, "tailored AST to", t, ':', x);
-      std::tie(it, std::ignore)
-        = st.checkers.emplace(type{slice->layout()}, std::move(*x));
+      std::tie(it, std::ignore) = st.checkers.emplace(
+        type{slice->layout()}, candidate_checker{*x, slice->layout()});
     }
     auto& checker = it->second;
     // Perform candidate check, splitting the slice into subsets if needed.
-    auto selection = evaluate(checker, *slice);
+    auto selection = checker(*slice);
     auto selection_size = rank(selection);
     if (selection_size == 0) {
       // No rows qualify.
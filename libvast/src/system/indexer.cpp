@@ -28,6 +28,9 @@
 #include "vast/view.hpp"
 
 #include <caf/attach_stream_sink.hpp>
+#include <caf/make_message.hpp>
+
+#include <vector>
 
 namespace vast::system {
 
@@ -92,6 +95,21 @@ caf::behavior indexer(caf::stateful_actor<indexer_state>* self, path filename,
       VAST_DEBUG(self, "got predicate:", pred);
       return self->state.col.lookup(pred.op, make_view(pred.rhs));
     },
+    [=](const std::vector<curried_predicate>& preds) {
+      VAST_DEBUG(self, "got", preds.size(), "predicates");
+      // Reply with one bitmap and one error per predicate, where the error is
+      // empty on success.
+      std::vector<ids> hits(preds.size());
+      std::vector<caf::error> errors(preds.size());
+      auto results = self->state.col.lookup(preds);
+      for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i])
+          hits[i] = std::move(*results[i]);
+        else
+          errors[i] = std::move(results[i].error());
+      }
+      return caf::make_message(std::move(hits), std::move(errors));
+    },
     [=](atom::persist) -> caf::result<void> {
       if (auto err = self->state.col.flush_to_disk(); err != caf::none)
         return err;
@@ -15,6 +15,7 @@
 
 #include "vast/caf_table_slice.hpp"
 #include "vast/caf_table_slice_builder.hpp"
+#include "vast/candidate_checker.hpp"
 #include "vast/chunk.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/assert.hpp"
@@ -131,6 +132,14 @@ void table_slice::append_column_to_index(size_type col,
     idx.append(at(row, col), offset() + row);
 }
 
+void table_slice::evaluate_column(size_type col, relational_operator op,
+                                  const data& rhs, ids& result) const {
+  auto& t = layout().fields[col].type;
+  auto y = make_data_view(rhs);
+  for (size_type row = 0; row < rows(); ++row)
+    result.append_bit(evaluate_view(to_canonical(t, at(row, col)), op, y));
+}
+
 bool operator==(const table_slice& x, const table_slice& y) {
   if (&x == &y)
     return true;
@@ -185,17 +194,14 @@ caf::error inspect(caf::deserializer& source, table_slice_ptr& ptr) {
 // slice and then calling GetTableSlice(buf). But until we touch the table
 // slice internals, we use this helper.
 caf::expected<flatbuffers::Offset<fbs::TableSliceBuffer>>
-pack(flatbuffers::FlatBufferBuilder& builder, table_slice_ptr x) {
+pack(flatbuffers::FlatBufferBuilder& builder, table_slice_ptr x,
+     uint32_t layout_id) {
   // This local builder instance will vanish once we can access the underlying
   // chunk of a table slice.
   flatbuffers::FlatBufferBuilder local_builder;
-  std::vector<char> layout_buffer;
-  caf::binary_serializer sink1{nullptr, layout_buffer};
-  if (auto error = sink1(x->layout()))
-    return error;
   std::vector<char> data_buffer;
-  caf::binary_serializer sink2{nullptr, data_buffer};
-  if (auto error = sink2(x))
+  caf::binary_serializer sink{nullptr, data_buffer};
+  if (auto error = x->serialize(sink))
     return error;
   auto transform = [](caf::atom_value x) -> caf::expected<fbs::Encoding> {
     if (x == caf::atom("caf"))
@@ -209,16 +215,14 @@ pack(flatbuffers::FlatBufferBuilder& builder, table_slice_ptr x) {
   auto encoding = transform(x->implementation_id());
   if (!encoding)
     return encoding.error();
-  auto layout_ptr = reinterpret_cast<const uint8_t*>(layout_buffer.data());
-  auto layout = local_builder.CreateVector(layout_ptr, layout_buffer.size());
   auto data_ptr = reinterpret_cast<const uint8_t*>(data_buffer.data());
   auto data = local_builder.CreateVector(data_ptr, data_buffer.size());
   fbs::TableSliceBuilder table_slice_builder{local_builder};
   table_slice_builder.add_offset(x->offset());
   table_slice_builder.add_rows(x->rows());
-  table_slice_builder.add_layout(layout);
   table_slice_builder.add_encoding(*encoding);
   table_slice_builder.add_data(data);
+  table_slice_builder.add_layout_id(layout_id);
   auto flat_slice = table_slice_builder.Finish();
   local_builder.Finish(flat_slice);
   auto buffer = span<const uint8_t>{local_builder.GetBufferPointer(),
@@ -238,6 +242,37 @@ caf::error unpack(const fbs::TableSlice& x, table_slice_ptr& y) {
   return source(y);
 }
 
+caf::error unpack(const fbs::TableSlice& x, record_type layout,
+                  table_slice_ptr& y) {
+  auto transform = [](fbs::Encoding x) -> caf::expected<caf::atom_value> {
+    switch (x) {
+      case fbs::Encoding::CAF:
+        return caf::atom("caf");
+      case fbs::Encoding::Arrow:
+        return caf::atom("arrow");
+      case fbs::Encoding::MessagePack:
+        return caf::atom("msgpack");
+    }
+    return make_error(ec::format_error, "unsupported table slice encoding");
+  };
+  auto id = transform(x.encoding());
+  if (!id)
+    return id.error();
+  table_slice_header header;
+  header.layout = std::move(layout);
+  header.rows = x.rows();
+  header.offset = x.offset();
+  auto result = factory<table_slice>::make(*id, std::move(header));
+  if (!result)
+    return ec::invalid_table_slice_type;
+  auto ptr = reinterpret_cast<const char*>(x.data()->Data());
+  caf::binary_deserializer source{nullptr, ptr, x.data()->size()};
+  if (auto err = result.unshared().deserialize(source))
+    return err;
+  y = std::move(result);
+  return caf::none;
+}
+
 caf::expected<std::vector<table_slice_ptr>>
 make_random_table_slices(size_t num_slices, size_t slice_size,
                          record_type layout, id offset, size_t seed) {
@@ -394,109 +429,8 @@ to_data(const std::vector<table_slice_ptr>& slices) {
   return result;
 }
 
-namespace {
-
-struct row_evaluator {
-  row_evaluator(const table_slice& slice, size_t row)
-    : slice_{slice}, row_{row} {
-    // nop
-  }
-
-  template <class T>
-  bool operator()(const data& d, const T& x) {
-    return (*this)(x, d);
-  }
-
-  template <class T, class U>
-  bool operator()(const T&, const U&) {
-    return false;
-  }
-
-  bool operator()(caf::none_t) {
-    return false;
-  }
-
-  bool operator()(const conjunction& c) {
-    for (auto& op : c)
-      if (!caf::visit(*this, op))
-        return false;
-    return true;
-  }
-
-  bool operator()(const disjunction& d) {
-    for (auto& op : d)
-      if (caf::visit(*this, op))
-        return true;
-    return false;
-  }
-
-  bool operator()(const negation& n) {
-    return !caf::visit(*this, n.expr());
-  }
-
-  bool operator()(const predicate& p) {
-    op_ = p.op;
-    return caf::visit(*this, p.lhs, p.rhs);
-  }
-
-  bool operator()(const attribute_extractor& e, const data& d) {
-    // TODO: Transform this AST node into a constant-time lookup node (e.g.,
-    // data_extractor). It's not necessary to iterate over the schema for every
-    // row; this should happen upfront.
-    if (e.attr == atom::type_v)
-      return evaluate(slice_.layout().name(), op_, d);
-    if (e.attr == atom::timestamp_v) {
-      for (size_t col = 0; col < slice_.layout().fields.size(); ++col) {
-        auto& field = slice_.layout().fields[col];
-        if (has_attribute(field.type, "timestamp")) {
-          if (!caf::holds_alternative<time_type>(field.type)) {
-            VAST_WARNING_ANON("got timestamp attribute for non-time type");
-            return false;
-          }
-        }
-        auto lhs = to_canonical(field.type, slice_.at(row_, col));
-        auto rhs = make_view(d);
-        return evaluate_view(lhs, op_, rhs);
-      }
-    }
-    return false;
-  }
-
-  bool operator()(const type_extractor&, const data&) {
-    die("type extractor should have been resolved at this point");
-  }
-
-  bool operator()(const field_extractor&, const data&) {
-    die("field extractor should have been resolved at this point");
-  }
-
-  bool operator()(const data_extractor& e, const data& d) {
-    VAST_ASSERT(e.offset.size() == 1);
-    if (e.type != slice_.layout()) // TODO: make this a precondition instead.
-      return false;
-    auto col = e.offset[0];
-    auto& field = slice_.layout().fields[col];
-    auto lhs = to_canonical(field.type, slice_.at(row_, col));
-    auto rhs = make_data_view(d);
-    return evaluate_view(lhs, op_, rhs);
-  }
-
-  const table_slice& slice_;
-  size_t row_;
-  relational_operator op_;
-};
-
-} // namespace
-
 ids evaluate(const expression& expr, const table_slice& slice) {
-  // TODO: switch to a column-based evaluation strategy where it makes sense.
-  ids result;
-  result.append(false, slice.offset());
-  for (size_t row = 0; row != slice.rows(); ++row) {
-    auto x = caf::visit(row_evaluator{slice, row}, expr);
-    result.append_bit(x);
-  }
-  return result;
+  return candidate_checker{expr, slice.layout()}(slice);
 }
 
 } // namespace vast
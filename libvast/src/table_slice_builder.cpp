@@ -17,9 +17,14 @@
 
 #include "vast/data.hpp"
 #include "vast/detail/overload.hpp"
+#include "vast/type.hpp"
 
 namespace vast {
 
+size_t table_slice_builder::column::size() const {
+  return caf::visit([](auto xs) { return xs.size(); }, values);
+}
+
 table_slice_builder::table_slice_builder(record_type layout)
   : layout_(std::move(layout)) { // nop
 }
@@ -42,6 +47,27 @@ bool table_slice_builder::recursive_add(const data& x, const type& t) {
     x, t);
 }
 
+bool table_slice_builder::append_integers(size_t col, span<const integer> xs,
+                                          span<const uint8_t> valid) {
+  return append(col, {xs, valid});
+}
+
+bool table_slice_builder::append_counts(size_t col, span<const count> xs,
+                                        span<const uint8_t> valid) {
+  return append(col, {xs, valid});
+}
+
+bool table_slice_builder::append_strings(size_t col,
+                                         span<const std::string_view> xs,
+                                         span<const uint8_t> valid) {
+  return append(col, {xs, valid});
+}
+
+bool table_slice_builder::append_addresses(size_t col, span<const address> xs,
+                                           span<const uint8_t> valid) {
+  return append(col, {xs, valid});
+}
+
 void table_slice_builder::reserve(size_t) {
   // nop
 }
@@ -50,6 +76,42 @@ size_t table_slice_builder::columns() const noexcept {
   return layout_.fields.size();
 }
 
+bool table_slice_builder::add_columns_impl(const std::vector<column>& xs,
+                                           size_t rows) {
+  for (size_t row = 0; row < rows; ++row)
+    for (auto& x : xs) {
+      auto add_value = [&](auto ys) { return add_impl(data_view{ys[row]}); };
+      auto ok = x.is_nil(row) ? add_impl(caf::none)
+                              : caf::visit(add_value, x.values);
+      if (!ok)
+        return false;
+    }
+  return true;
+}
+
+bool table_slice_builder::append(size_t col, column x) {
+  auto column_type = detail::overload(
+    [](span<const integer>) -> type { return integer_type{}; },
+    [](span<const count>) -> type { return count_type{}; },
+    [](span<const std::string_view>) -> type { return string_type{}; },
+    [](span<const address>) -> type { return address_type{}; });
+  auto valid = col == columns_.size() && col < columns()
+               && (x.valid.empty() || x.valid.size() == x.size())
+               && (columns_.empty() || x.size() == columns_.front().size())
+               && congruent(layout_.fields[col].type,
+                            caf::visit(column_type, x.values));
+  if (!valid) {
+    columns_.clear();
+    return false;
+  }
+  columns_.push_back(x);
+  if (columns_.size() < columns())
+    return true;
+  auto result = add_columns_impl(columns_, x.size());
+  columns_.clear();
+  return result;
+}
+
 void intrusive_ptr_add_ref(const table_slice_builder* ptr) {
   intrusive_ptr_add_ref(static_cast<const caf::ref_counted*>(ptr));
 }
@@ -15,9 +15,11 @@
 
 #include "vast/base.hpp"
 #include "vast/defaults.hpp"
+#include "vast/fbs/utils.hpp"
 
 #include <caf/settings.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 namespace vast {
@@ -71,21 +73,71 @@ value_index::lookup(relational_operator op, data_view x) const {
   auto result = lookup_impl(op, x);
   if (!result)
     return result;
+  return finish_lookup(op, std::move(*result));
+}
+
+caf::expected<std::vector<ids>>
+value_index::lookup_batch(relational_operator op,
+                          const std::vector<data_view>& xs) const {
+  std::vector<ids> result(xs.size());
+  // Answer nil values right here and forward the others to the concrete
+  // implementation in a single batch.
+  std::vector<data_view> values;
+  std::vector<size_t> positions;
+  values.reserve(xs.size());
+  positions.reserve(xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    if (caf::holds_alternative<caf::none_t>(xs[i])) {
+      auto hits = lookup(op, xs[i]);
+      if (!hits)
+        return hits.error();
+      result[i] = std::move(*hits);
+    } else {
+      values.push_back(xs[i]);
+      positions.push_back(i);
+    }
+  }
+  if (values.empty())
+    return result;
+  auto hits = lookup_batch_impl(op, values);
+  if (!hits)
+    return hits.error();
+  VAST_ASSERT(hits->size() == values.size());
+  for (size_t i = 0; i < positions.size(); ++i)
+    result[positions[i]] = finish_lookup(op, std::move((*hits)[i]));
+  return result;
+}
+
+caf::expected<std::vector<ids>>
+value_index::lookup_batch_impl(relational_operator op,
+                               const std::vector<data_view>& xs) const {
+  std::vector<ids> result;
+  result.reserve(xs.size());
+  for (auto& x : xs) {
+    auto hits = lookup_impl(op, x);
+    if (!hits)
+      return hits.error();
+    result.push_back(std::move(*hits));
+  }
+  return result;
+}
+
+ids value_index::finish_lookup(relational_operator op, ids result) const {
   // The result can only have mass (i.e., 1-bits) where actual IDs exist.
-  *result &= mask_;
+  result &= mask_;
   // Because the value index implementations never see nil values, they need
   // to be handled here. If we have a predicate with a non-nil RHS and `!=` as
   // operator, then we need to add the nils to the result, because the
   // expression `nil != RHS` is true when RHS is not nil.
   auto is_negation = op == not_equal;
   if (is_negation)
-    *result |= none_;
+    result |= none_;
   // Finally, the concrete result may be too short, e.g., when the last values
   // have been nils. In this case we need to fill it up. For any operator other
   // than !=, the result of comparing with nil is undefined.
-  if (result->size() < offset())
-    result->append_bits(is_negation, offset() - result->size());
-  return std::move(*result);
+  if (result.size() < offset())
+    result.append_bits(is_negation, offset() - result.size());
+  return result;
 }
 
 value_index::size_type value_index::offset() const {
@@ -108,6 +160,17 @@ caf::error value_index::deserialize(caf::deserializer& source) {
   return source(mask_, none_);
 }
 
+caf::expected<value_index::packed_state>
+value_index::pack_impl(flatbuffers::FlatBufferBuilder&) const {
+  return make_error(ec::unimplemented, "no flatbuffer support for index of type",
+                    type_);
+}
+
+caf::error value_index::unpack_impl(const fbs::ValueIndex&) {
+  return make_error(ec::unimplemented, "no flatbuffer support for index of type",
+                    type_);
+}
+
 const ewah_bitmap& value_index::mask() const {
   return mask_;
 }
@@ -149,6 +212,98 @@ caf::error inspect(caf::deserializer& source, value_index_ptr& x) {
   return x->deserialize(source);
 }
 
+caf::expected<flatbuffers::Offset<fbs::ValueIndex>>
+pack(flatbuffers::FlatBufferBuilder& builder, const value_index& x) {
+  auto state = x.pack_impl(builder);
+  if (!state)
+    return state.error();
+  auto type = detail::pack_caf_binary(builder, x.type());
+  if (!type)
+    return type.error();
+  auto options = detail::pack_caf_binary(builder, x.options());
+  if (!options)
+    return options.error();
+  auto mask = detail::pack_bitmap(builder, x.mask_);
+  auto none = detail::pack_bitmap(builder, x.none_);
+  fbs::ValueIndexBuilder value_index_builder{builder};
+  value_index_builder.add_version(fbs::Version::v0);
+  value_index_builder.add_type(*type);
+  value_index_builder.add_options(*options);
+  value_index_builder.add_mask(mask);
+  value_index_builder.add_none(none);
+  value_index_builder.add_state_type(state->first);
+  value_index_builder.add_state(state->second);
+  return value_index_builder.Finish();
+}
+
+caf::expected<flatbuffers::Offset<fbs::ValueIndex>>
+pack(flatbuffers::FlatBufferBuilder& builder, const value_index_ptr& x) {
+  if (x == nullptr)
+    return make_error(ec::invalid_argument, "cannot pack a null value index");
+  return pack(builder, *x);
+}
+
+caf::error unpack(const fbs::ValueIndex& x, value_index& y) {
+  if (auto err = fbs::check_version(x.version(), fbs::Version::v0))
+    return err;
+  return caf::error::eval(
+    [&] { return detail::unpack_bitmap(x.mask(), y.mask_); },
+    [&] { return detail::unpack_bitmap(x.none(), y.none_); },
+    [&] { return y.unpack_impl(x); });
+}
+
+caf::error unpack(const fbs::ValueIndex& x, value_index_ptr& y) {
+  type t;
+  if (auto err = detail::unpack_caf_binary(x.type(), t))
+    return err;
+  caf::settings opts;
+  if (auto err = detail::unpack_caf_binary(x.options(), opts))
+    return err;
+  y = factory<value_index>::make(std::move(t), std::move(opts));
+  if (y == nullptr)
+    return make_error(ec::unspecified, "failed to construct value index");
+  return unpack(x, *y);
+}
+
+namespace detail {
+
+flatbuffers::Offset<fbs::EWAHBitmap>
+pack_bitmap(flatbuffers::FlatBufferBuilder& builder, const ewah_bitmap& x) {
+  auto& blocks = x.blocks();
+  auto blocks_offset = builder.CreateVector(blocks.data(), blocks.size());
+  return fbs::CreateEWAHBitmap(builder, blocks_offset, x.last_marker(),
+                               x.size());
+}
+
+caf::expected<flatbuffers::Offset<fbs::EWAHBitmap>>
+pack_bitmap(flatbuffers::FlatBufferBuilder& builder, const bitmap& x) {
+  if (auto bm = caf::get_if<ewah_bitmap>(&x.get_data()))
+    return pack_bitmap(builder, *bm);
+  return make_error(ec::unimplemented, "only EWAH bitmaps can be packed");
+}
+
+caf::error unpack_bitmap(const fbs::EWAHBitmap* x, ewah_bitmap& y) {
+  if (!x || !x->blocks())
+    return make_error(ec::format_error, "missing bitmap");
+  auto blocks = x->blocks();
+  if (!blocks->empty() && x->last_marker() >= blocks->size())
+    return make_error(ec::format_error, "invalid EWAH marker position");
+  auto first = blocks->data();
+  y = ewah_bitmap{ewah_bitmap::block_vector(first, first + blocks->size()),
+                  x->last_marker(), x->num_bits()};
+  return caf::none;
+}
+
+caf::error unpack_bitmap(const fbs::EWAHBitmap* x, bitmap& y) {
+  ewah_bitmap bm;
+  if (auto err = unpack_bitmap(x, bm))
+    return err;
+  y = bitmap{std::move(bm)};
+  return caf::none;
+}
+
+} // namespace detail
+
 // -- string_index -------------------------------------------------------------
 
 string_index::string_index(vast::type t, caf::settings opts)
@@ -256,6 +411,194 @@ string_index::lookup_impl(relational_operator op, data_view x) const {
     x);
 }
 
+caf::expected<value_index::packed_state>
+string_index::pack_impl(flatbuffers::FlatBufferBuilder& builder) const {
+  auto length = detail::pack_bitmap_index(builder, length_);
+  if (!length)
+    return length.error();
+  auto chars = detail::pack_bitmap_indexes(builder, chars_);
+  if (!chars)
+    return chars.error();
+  auto state = fbs::CreateStringIndex(builder, max_length_, *length, *chars);
+  return packed_state{fbs::ValueIndexState::string, state.Union()};
+}
+
+caf::error string_index::unpack_impl(const fbs::ValueIndex& x) {
+  auto state = x.state_as_string();
+  if (!state)
+    return make_error(ec::format_error, "expected string index state");
+  max_length_ = state->max_length();
+  return caf::error::eval(
+    [&] { return detail::unpack_bitmap_index(state->length(), length_); },
+    [&] { return detail::unpack_bitmap_indexes(state->chars(), chars_); });
+}
+
+// -- dictionary_index ---------------------------------------------------------
+
+dictionary_index::dictionary_index(vast::type t, caf::settings opts)
+  : value_index{std::move(t), std::move(opts)} {
+  max_cardinality_ = caf::get_or(options(), "max-dictionary-size",
+                                 defaults::index::max_dictionary_size);
+  index_ = index{max_cardinality_};
+}
+
+caf::error dictionary_index::serialize(caf::serializer& sink) const {
+  auto has_fallback = fallback_ != nullptr;
+  return caf::error::eval(
+    [&] { return value_index::serialize(sink); },
+    [&] { return sink(max_cardinality_, has_fallback); },
+    [&] {
+      if (has_fallback)
+        return fallback_->serialize(sink);
+      return sink(dictionary_, index_);
+    });
+}
+
+caf::error dictionary_index::deserialize(caf::deserializer& source) {
+  auto has_fallback = false;
+  if (auto err = caf::error::eval(
+        [&] { return value_index::deserialize(source); },
+        [&] { return source(max_cardinality_, has_fallback); }))
+    return err;
+  ids_.clear();
+  dictionary_.clear();
+  if (has_fallback) {
+    index_ = index{};
+    fallback_ = std::make_unique<string_index>(type(), options());
+    return fallback_->deserialize(source);
+  }
+  fallback_ = nullptr;
+  if (auto err = source(dictionary_, index_))
+    return err;
+  for (uint32_t i = 0; i < dictionary_.size(); ++i)
+    ids_.emplace(dictionary_[i], i);
+  return caf::none;
+}
+
+size_t dictionary_index::cardinality() const {
+  return dictionary_.size();
+}
+
+bool dictionary_index::is_fallback() const {
+  return fallback_ != nullptr;
+}
+
+bool dictionary_index::append_impl(data_view x, id pos) {
+  auto str = caf::get_if<view<std::string>>(&x);
+  if (!str)
+    return false;
+  if (fallback_)
+    return static_cast<bool>(fallback_->append(x, pos));
+  auto i = ids_.find(*str);
+  if (i == ids_.end()) {
+    if (dictionary_.size() == max_cardinality_) {
+      make_fallback();
+      return static_cast<bool>(fallback_->append(x, pos));
+    }
+    auto id = static_cast<uint32_t>(dictionary_.size());
+    dictionary_.emplace_back(*str);
+    i = ids_.emplace(dictionary_.back(), id).first;
+  }
+  index_.skip(pos - index_.size());
+  index_.append(i->second);
+  return true;
+}
+
+caf::expected<ids>
+dictionary_index::lookup_impl(relational_operator op, data_view x) const {
+  if (fallback_)
+    return fallback_->lookup(op, x);
+  return caf::visit(
+    detail::overload(
+      [&](auto x) -> caf::expected<ids> {
+        return make_error(ec::type_clash, materialize(x));
+      },
+      [&](view<std::string> str) -> caf::expected<ids> {
+        switch (op) {
+          default:
+            return make_error(ec::unsupported_operator, op);
+          case equal:
+          case not_equal: {
+            auto i = ids_.find(str);
+            if (i == ids_.end())
+              return ids{offset(), op == not_equal};
+            return index_.lookup(op, i->second);
+          }
+          case ni:
+          case not_ni: {
+            // Substring search only needs to consider the distinct values.
+            ids result{offset(), false};
+            for (uint32_t i = 0; i < dictionary_.size(); ++i)
+              if (dictionary_[i].find(str) != std::string::npos)
+                result |= index_.lookup(equal, i);
+            if (op == not_ni)
+              result.flip();
+            return result;
+          }
+        }
+      },
+      [&](view<list> xs) { return detail::container_lookup(*this, op, xs); }),
+    x);
+}
+
+caf::expected<value_index::packed_state>
+dictionary_index::pack_impl(flatbuffers::FlatBufferBuilder& builder) const {
+  flatbuffers::Offset<fbs::ValueIndex> fallback;
+  if (fallback_) {
+    auto packed = pack(builder, *fallback_);
+    if (!packed)
+      return packed.error();
+    fallback = *packed;
+  }
+  auto dictionary = builder.CreateVectorOfStrings(dictionary_);
+  auto index = detail::pack_bitmap_index(builder, index_);
+  if (!index)
+    return index.error();
+  auto state = fbs::CreateDictionaryIndex(builder, max_cardinality_,
+                                          dictionary, *index, fallback);
+  return packed_state{fbs::ValueIndexState::dictionary, state.Union()};
+}
+
+caf::error dictionary_index::unpack_impl(const fbs::ValueIndex& x) {
+  auto state = x.state_as_dictionary();
+  if (!state || !state->dictionary())
+    return make_error(ec::format_error, "expected dictionary index state");
+  max_cardinality_ = state->max_cardinality();
+  ids_.clear();
+  dictionary_.clear();
+  if (auto fallback = state->fallback()) {
+    index_ = index{};
+    fallback_ = std::make_unique<string_index>(type(), options());
+    return unpack(*fallback, *fallback_);
+  }
+  fallback_ = nullptr;
+  dictionary_.reserve(state->dictionary()->size());
+  for (auto str : *state->dictionary())
+    dictionary_.emplace_back(str->str());
+  for (uint32_t i = 0; i < dictionary_.size(); ++i)
+    ids_.emplace(dictionary_[i], i);
+  return detail::unpack_bitmap_index(state->index(), index_);
+}
+
+void dictionary_index::make_fallback() {
+  VAST_ASSERT(!fallback_);
+  // Restore the original order of all values appended so far, and replay them
+  // into a string index.
+  std::vector<std::pair<id, uint32_t>> rows;
+  rows.reserve(rank(mask()));
+  for (uint32_t i = 0; i < dictionary_.size(); ++i)
+    for (auto pos : select(index_.coder().bitmap_at(i)))
+      rows.emplace_back(pos, i);
+  std::sort(rows.begin(), rows.end());
+  fallback_ = std::make_unique<string_index>(type(), options());
+  for (auto [pos, i] : rows)
+    fallback_->append(make_data_view(dictionary_[i]), pos);
+  index_ = index{};
+  ids_.clear();
+  dictionary_.clear();
+  dictionary_.shrink_to_fit();
+}
+
 // -- enumeration_index --------------------------------------------------------
 
 enumeration_index::enumeration_index(vast::type t, caf::settings opts)
@@ -299,6 +642,22 @@ enumeration_index::lookup_impl(relational_operator op, data_view d) const {
     d);
 }
 
+caf::expected<value_index::packed_state>
+enumeration_index::pack_impl(flatbuffers::FlatBufferBuilder& builder) const {
+  auto index = detail::pack_bitmap_index(builder, index_);
+  if (!index)
+    return index.error();
+  auto state = fbs::CreateEnumerationIndex(builder, *index);
+  return packed_state{fbs::ValueIndexState::enumeration, state.Union()};
+}
+
+caf::error enumeration_index::unpack_impl(const fbs::ValueIndex& x) {
+  auto state = x.state_as_enumeration();
+  if (!state)
+    return make_error(ec::format_error, "expected enumeration index state");
+  return detail::unpack_bitmap_index(state->index(), index_);
+}
+
 // -- address_index ------------------------------------------------------------
 
 address_index::address_index(vast::type t, caf::settings opts)
@@ -377,10 +736,110 @@ address_index::lookup_impl(relational_operator op, data_view d) const {
           result.flip();
         return result;
       },
-      [&](view<list> xs) { return detail::container_lookup(*this, op, xs); }),
+      [&](view<list> xs) {
+        // A list of subnets checks for membership in any of the subnets.
+        auto is_subnet = [](const data_view& x) {
+          return caf::holds_alternative<view<subnet>>(x);
+        };
+        auto subnets = xs->size() > 0
+                       && std::all_of(xs->begin(), xs->end(), is_subnet);
+        return detail::container_lookup_batch(*this, op, xs,
+                                              subnets ? in : equal);
+      }),
     d);
 }
 
+caf::expected<std::vector<ids>>
+address_index::lookup_batch_impl(relational_operator op,
+                                 const std::vector<data_view>& xs) const {
+  // Both equality and subnet membership boil down to matching a prefix of
+  // the address bytes, so we represent every value as a subnet.
+  std::vector<std::pair<subnet, size_t>> prefixes;
+  prefixes.reserve(xs.size());
+  for (size_t i = 0; i < xs.size(); ++i) {
+    if ((op == equal || op == not_equal)
+        && caf::holds_alternative<view<address>>(xs[i])) {
+      auto& x = caf::get<view<address>>(xs[i]);
+      auto length = static_cast<uint8_t>(x.is_v4() ? 32 : 128);
+      prefixes.emplace_back(subnet{x, length}, i);
+    } else if ((op == in || op == not_in)
+               && caf::holds_alternative<view<subnet>>(xs[i])) {
+      auto& x = caf::get<view<subnet>>(xs[i]);
+      if (x.length() == 0)
+        return make_error(ec::unspecified,
+                          "invalid IP subnet length: ", x.length());
+      prefixes.emplace_back(x, i);
+    } else {
+      return value_index::lookup_batch_impl(op, xs);
+    }
+  }
+  // Sorting the prefixes lets us walk them like a prefix tree: prefixes
+  // sharing their first k bytes also share the conjunction of the first k
+  // byte bitmaps, which we compute only once. A prefix without any hits
+  // prunes all prefixes below it.
+  std::sort(prefixes.begin(), prefixes.end());
+  std::vector<ids> result(xs.size());
+  // prefix[k] holds the conjunction of the first k byte bitmaps of the
+  // previous network, valid up to and including the index `valid`.
+  std::array<ids, 17> prefix;
+  const address* prev = nullptr;
+  size_t valid = 0;
+  for (auto& [x, pos] : prefixes) {
+    auto& network = x.network();
+    auto& bytes = network.data();
+    auto is_v4 = network.is_v4();
+    auto first = is_v4 ? 12u : 0u;
+    auto last = first + x.length() / 8u;
+    auto k = first;
+    if (prev != nullptr && prev->is_v4() == is_v4)
+      while (k < valid && k < last && prev->data()[k] == bytes[k])
+        ++k;
+    else
+      prefix[first] = is_v4 ? ids{v4_.coder().storage()} : ids{offset(), true};
+    for (; k < last && !all<0>(prefix[k]); ++k) {
+      prefix[k + 1] = prefix[k];
+      prefix[k + 1] &= bytes_[k].lookup(equal, bytes[k]);
+    }
+    valid = k;
+    auto hits = ids{offset(), false};
+    if (k == last && !all<0>(prefix[last])) {
+      hits = prefix[last];
+      // Subnets that end within a byte need to check the remaining bits.
+      for (auto j = 0u; j < x.length() % 8u; ++j) {
+        auto bit = 7 - j;
+        auto& bm = bytes_[last].coder().storage()[bit];
+        hits &= (bytes[last] >> bit) & 1 ? ~bm : bm;
+      }
+    }
+    if (op == not_equal || op == not_in)
+      hits.flip();
+    result[pos] = std::move(hits);
+    prev = &network;
+  }
+  return result;
+}
+
+caf::expected<value_index::packed_state>
+address_index::pack_impl(flatbuffers::FlatBufferBuilder& builder) const {
+  auto bytes = detail::pack_bitmap_indexes(builder, bytes_);
+  if (!bytes)
+    return bytes.error();
+  auto v4 = detail::pack_bitmap_index(builder, v4_);
+  if (!v4)
+    return v4.error();
+  auto state = fbs::CreateAddressIndex(builder, *bytes, *v4);
+  return packed_state{fbs::ValueIndexState::address, state.Union()};
+}
+
+caf::error address_index::unpack_impl(const fbs::ValueIndex& x) {
+  auto state = x.state_as_address();
+  if (!state)
+    return make_error(ec::format_error, "expected address index state");
+  return caf::error::eval(
+    [&] { return detail::unpack_bitmap_indexes(state->bytes(), bytes_); },
+    [&] { return detail::unpack_bitmap_index(state->v4(), v4_); });
+}
+
 // -- subnet_index -------------------------------------------------------------
 
 subnet_index::subnet_index(vast::type x, caf::settings opts)
@@ -486,6 +945,27 @@ subnet_index::lookup_impl(relational_operator op, data_view d) const {
     d);
 }
 
+caf::expected<value_index::packed_state>
+subnet_index::pack_impl(flatbuffers::FlatBufferBuilder& builder) const {
+  auto network = pack(builder, network_);
+  if (!network)
+    return network.error();
+  auto length = detail::pack_bitmap_index(builder, length_);
+  if (!length)
+    return length.error();
+  auto state = fbs::CreateSubnetIndex(builder, *network, *length);
+  return packed_state{fbs::ValueIndexState::subnet, state.Union()};
+}
+
+caf::error subnet_index::unpack_impl(const fbs::ValueIndex& x) {
+  auto state = x.state_as_subnet();
+  if (!state || !state->network())
+    return make_error(ec::format_error, "expected subnet index state");
+  return caf::error::eval(
+    [&] { return unpack(*state->network(), network_); },
+    [&] { return detail::unpack_bitmap_index(state->length(), length_); });
+}
+
 // -- port_index ---------------------------------------------------------------
 
 port_index::port_index(vast::type t, caf::settings opts)
@@ -542,6 +1022,27 @@ port_index::lookup_impl(relational_operator op, data_view d) const {
     d);
 }
 
+caf::expected<value_index::packed_state>
+port_index::pack_impl(flatbuffers::FlatBufferBuilder& builder) const {
+  auto number = detail::pack_bitmap_index(builder, num_);
+  if (!number)
+    return number.error();
+  auto protocol = detail::pack_bitmap_index(builder, proto_);
+  if (!protocol)
+    return protocol.error();
+  auto state = fbs::CreatePortIndex(builder, *number, *protocol);
+  return packed_state{fbs::ValueIndexState::port, state.Union()};
+}
+
+caf::error port_index::unpack_impl(const fbs::ValueIndex& x) {
+  auto state = x.state_as_port();
+  if (!state)
+    return make_error(ec::format_error, "expected port index state");
+  return caf::error::eval(
+    [&] { return detail::unpack_bitmap_index(state->number(), num_); },
+    [&] { return detail::unpack_bitmap_index(state->protocol(), proto_); });
+}
+
 // -- list_index -----------------------------------------------------------
 
 list_index::list_index(vast::type t, caf::settings opts)
@@ -616,4 +1117,41 @@ list_index::lookup_impl(relational_operator op, data_view x) const {
   return result;
 }
 
+caf::expected<value_index::packed_state>
+list_index::pack_impl(flatbuffers::FlatBufferBuilder& builder) const {
+  std::vector<flatbuffers::Offset<fbs::ValueIndex>> elements;
+  elements.reserve(elements_.size());
+  for (auto& element : elements_) {
+    auto packed = pack(builder, element);
+    if (!packed)
+      return packed.error();
+    elements.push_back(*packed);
+  }
+  auto elements_offset = builder.CreateVector(elements);
+  auto size = detail::pack_bitmap_index(builder, size_);
+  if (!size)
+    return size.error();
+  auto value_type = detail::pack_caf_binary(builder, value_type_);
+  if (!value_type)
+    return value_type.error();
+  auto state = fbs::CreateListIndex(builder, max_size_, *size, elements_offset,
+                                    *value_type);
+  return packed_state{fbs::ValueIndexState::list, state.Union()};
+}
+
+caf::error list_index::unpack_impl(const fbs::ValueIndex& x) {
+  auto state = x.state_as_list();
+  if (!state || !state->elements())
+    return make_error(ec::format_error, "expected list index state");
+  max_size_ = state->max_size();
+  elements_.clear();
+  elements_.resize(state->elements()->size());
+  for (size_t i = 0; i < elements_.size(); ++i)
+    if (auto err = unpack(*state->elements()->Get(i), elements_[i]))
+      return err;
+  return caf::error::eval(
+    [&] { return detail::unpack_bitmap_index(state->size(), size_); },
+    [&] { return detail::unpack_caf_binary(state->value_type(), value_type_); });
+}
+
 } // namespace vast
@@ -56,7 +56,14 @@ value_index_ptr make(type x, caf::settings opts) {
     }
   }
   if (auto a = find_attribute(x, "index")) {
-    if (auto value = a->value)
+    if (auto value = a->value) {
+      if (*value == "dictionary"sv) {
+        if (caf::holds_alternative<string_type>(x))
+          return std::make_unique<dictionary_index>(std::move(x),
+                                                    std::move(opts));
+        VAST_WARNING_ANON(__func__, "dictionary index requires a string type, "
+                                    "ignoring index attribute");
+      }
       if (*value == "hash"sv) {
         auto i = opts.find("cardinality");
         if (i == opts.end())
@@ -112,6 +119,7 @@ value_index_ptr make(type x, caf::settings opts) {
             return std::make_unique<hash_index<8>>(std::move(x));
         }
       }
+    }
   }
   return std::make_unique<T>(std::move(x), std::move(opts));
 }
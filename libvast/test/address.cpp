@@ -17,6 +17,8 @@
 #include "vast/concept/printable/vast/address.hpp"
 #include "vast/address.hpp"
 
+#include <algorithm>
+
 #define SUITE address
 #include "vast/test/test.hpp"
 
@@ -160,3 +162,29 @@ TEST(parseable) {
   CHECK(a.is_v6());
   CHECK(to_string(a) == str);
 }
+
+TEST(parseable - IPv4 fast path) {
+  // The hand-written IPv4 parser must agree with the combinator version on
+  // both the result and the consumed input.
+  auto v4 = address_parser::make_v4();
+  auto inputs = {"0.0.0.0"s,        "255.255.255.255"s, "10.0.0.1"s,
+                 "010.000.1.01"s,   "1.2.3.4.5"s,       "1.2.3.1234"s,
+                 "1.2.3.256"s,      "256.1.2.3"s,       "1.2.3"s,
+                 "1.2.3."s,         "1..2.3"s,          ".1.2.3"s,
+                 "1.2.3.4:80"s,     "1.2.3.4/24"s,      "-1.2.3.4"s,
+                 "+1.2.3.4"s,       "::ffff:1.2.3.4"s,  ""s};
+  for (auto& str : inputs) {
+    MESSAGE(str);
+    uint8_t expected[4] = {};
+    uint8_t actual[4] = {};
+    auto f0 = str.begin();
+    auto f1 = str.begin();
+    auto r0 = v4(f0, str.end(), expected[0], expected[1], expected[2],
+                 expected[3]);
+    auto r1 = address_parser::parse_v4(f1, str.end(), actual);
+    REQUIRE_EQUAL(r0, r1);
+    CHECK(f0 == f1);
+    if (r0)
+      CHECK(std::equal(expected, expected + 4, actual));
+  }
+}
@@ -10,6 +10,8 @@
 #include "vast/concept/parseable/vast/address.hpp"
 #include "vast/concept/parseable/vast/port.hpp"
 #include "vast/concept/parseable/vast/subnet.hpp"
+#include "vast/ids.hpp"
+#include "vast/operator.hpp"
 #include "vast/type.hpp"
 
 #include <caf/make_copy_on_write.hpp>
@@ -356,6 +358,51 @@ TEST(single column - serialization) {
   CHECK_VARIANT_EQUAL(*slice1, *slice2);
 }
 
+TEST(column evaluation) {
+  using vast::address;
+  using vast::subnet;
+  using vast::to;
+  auto layout = record_type{{"c", count_type{}},    {"i", integer_type{}},
+                            {"r", real_type{}},     {"s", string_type{}},
+                            {"a", address_type{}},  {"t", time_type{}},
+                            {"e", enumeration_type{{"x", "y"}}}};
+  auto a1 = unbox(to<address>("10.0.0.1"));
+  auto a2 = unbox(to<address>("192.168.0.1"));
+  auto epoch = vast::time{duration{0}};
+  auto slice = make_slice(layout,
+                          1_c, -1_i, 0.5, "foo"sv, a1, epoch, 0_e,
+                          2_c, 0_i, 1.5, "bar"sv, a2, epoch + 1h, 1_e,
+                          caf::none, caf::none, caf::none, caf::none,
+                          caf::none, caf::none, caf::none,
+                          3_c, 5_i, 2.5, "boo"sv, a1, epoch + 2h, 0_e);
+  auto rhs = std::vector<data>{caf::none,
+                               1_c,
+                               2_c,
+                               0_i,
+                               1.5,
+                               "foo"s,
+                               "oo"s,
+                               "xfoox"s,
+                               "x"s,
+                               a1,
+                               unbox(to<subnet>("10.0.0.0/8")),
+                               epoch + 1h};
+  auto ops = {match,     not_match, in,   not_in,     ni,      not_ni,
+              equal,     not_equal, less, less_equal, greater, greater_equal};
+  // Every predicate must yield the same result as the row-wise default.
+  for (size_t col = 0; col < slice->columns(); ++col) {
+    for (auto op : ops) {
+      for (auto& x : rhs) {
+        ids expected;
+        ids actual;
+        slice->table_slice::evaluate_column(col, op, x, expected);
+        slice->evaluate_column(col, op, x, actual);
+        CHECK_EQUAL(actual, expected);
+      }
+    }
+  }
+}
+
 FIXTURE_SCOPE(arrow_table_slice_tests, fixtures::table_slices)
 
 TEST_TABLE_SLICE(arrow_table_slice)
@@ -0,0 +1,50 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE worker_pool
+
+#include "vast/detail/worker_pool.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+using namespace vast::detail;
+
+TEST(run all tasks) {
+  worker_pool pool{4};
+  CHECK_EQUAL(pool.size(), 4u);
+  std::vector<size_t> xs(1000, 0);
+  pool.run(xs.size(), [&](size_t i) { xs[i] = i; });
+  for (size_t i = 0; i < xs.size(); ++i)
+    CHECK_EQUAL(xs[i], i);
+}
+
+TEST(run multiple batches) {
+  worker_pool pool{3};
+  std::atomic<size_t> sum{0};
+  for (size_t batch = 0; batch < 100; ++batch)
+    pool.run(10, [&](size_t i) { sum += i; });
+  CHECK_EQUAL(sum.load(), 100u * 45u);
+}
+
+TEST(single thread) {
+  worker_pool pool{1};
+  CHECK_EQUAL(pool.size(), 1u);
+  size_t calls = 0;
+  pool.run(5, [&](size_t) { ++calls; });
+  pool.run(0, [&](size_t) { ++calls; });
+  CHECK_EQUAL(calls, 5u);
+}
@@ -16,6 +16,7 @@
 #include "vast/test/fixtures/events.hpp"
 #include "vast/test/test.hpp"
 
+#include "vast/candidate_checker.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/expression.hpp"
 #include "vast/concept/parseable/vast/time.hpp"
@@ -27,6 +28,8 @@
 
 #include <caf/test/dsl.hpp>
 
+#include <algorithm>
+
 using namespace vast;
 
 namespace {
@@ -49,6 +52,50 @@ struct fixture : fixtures::events {
   table_slice_ptr zeek_conn_log_slice;
 };
 
+// Evaluates a tailored expression for a single row, as a reference for the
+// column-wise evaluation.
+struct row_evaluator {
+  bool operator()(caf::none_t) {
+    return false;
+  }
+
+  bool operator()(const conjunction& xs) {
+    return std::all_of(xs.begin(), xs.end(),
+                       [&](auto& x) { return caf::visit(*this, x); });
+  }
+
+  bool operator()(const disjunction& xs) {
+    return std::any_of(xs.begin(), xs.end(),
+                       [&](auto& x) { return caf::visit(*this, x); });
+  }
+
+  bool operator()(const negation& x) {
+    return !caf::visit(*this, x.expr());
+  }
+
+  bool operator()(const predicate& x) {
+    auto lhs = caf::get_if<data_extractor>(&x.lhs);
+    auto rhs = caf::get_if<data>(&x.rhs);
+    if (!lhs || !rhs)
+      FAIL("expected a tailored predicate");
+    auto col = lhs->offset[0];
+    auto& type = slice.layout().fields[col].type;
+    return evaluate_view(to_canonical(type, slice.at(row, col)), x.op,
+                         make_data_view(*rhs));
+  }
+
+  const table_slice& slice;
+  size_t row;
+};
+
+ids evaluate_rows(const expression& expr, const table_slice& slice) {
+  ids result;
+  result.append(false, slice.offset());
+  for (size_t row = 0; row < slice.rows(); ++row)
+    result.append_bit(caf::visit(row_evaluator{slice, row}, expr));
+  return result;
+}
+
 } // namespace
 
 FIXTURE_SCOPE(evaluation_tests, fixture)
@@ -105,6 +152,45 @@ TEST(evaluation - field extractor - service + orig_h) {
   REQUIRE_EQUAL(rank(ids), 2u);
 }
 
+TEST(evaluation - connectives) {
+  auto rows = zeek_conn_log_slice->rows();
+  auto udp = evaluate(make_conn_expr("proto == \"udp\""), *zeek_conn_log_slice);
+  auto tcp = evaluate(make_conn_expr("proto == \"tcp\""), *zeek_conn_log_slice);
+  REQUIRE_EQUAL(udp.size(), rows);
+  auto not_udp
+    = evaluate(make_conn_expr("! (proto == \"udp\")"), *zeek_conn_log_slice);
+  CHECK_EQUAL(not_udp, ~udp);
+  auto either = evaluate(make_conn_expr("proto == \"udp\" || proto == "
+                                        "\"tcp\""),
+                         *zeek_conn_log_slice);
+  CHECK_EQUAL(either, udp | tcp);
+  auto none = evaluate(make_conn_expr("proto == \"udp\" && proto == "
+                                      "\"tcp\""),
+                       *zeek_conn_log_slice);
+  CHECK_EQUAL(none.size(), rows);
+  CHECK(all<0>(none));
+}
+
+TEST(evaluation - compiled candidate checker) {
+  // A checker compiles once per layout and then applies to all slices of
+  // that layout, respecting their offsets.
+  auto expr = make_conn_expr("orig_h != 192.168.1.102 && proto != \"udp\"");
+  auto checker = candidate_checker{expr, zeek_conn_log_slice->layout()};
+  CHECK_EQUAL(rank(checker(*zeek_conn_log_slice)), 10u);
+  for (auto& slice : zeek_conn_log_full) {
+    auto ids = checker(*slice);
+    CHECK_EQUAL(ids.size(), slice->offset() + slice->rows());
+    CHECK_EQUAL(ids, evaluate_rows(expr, *slice));
+  }
+  MESSAGE("connectives and negations match the row-wise evaluation");
+  auto str = "! (proto == \"udp\") && (orig_bytes > 1000 || duration > 5s)";
+  auto other = make_conn_expr(str);
+  auto other_checker = candidate_checker{other, zeek_conn_log_slice->layout()};
+  auto expected = evaluate_rows(other, *zeek_conn_log_slice);
+  CHECK(any<1>(expected));
+  CHECK_EQUAL(other_checker(*zeek_conn_log_slice), expected);
+}
+
 TEST(evaluation - field extractor - nonexistant field) {
   auto expr = make_conn_expr("devnull != nil");
   auto ids = evaluate(expr, *zeek_conn_log_slice);
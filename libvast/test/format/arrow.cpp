@@ -26,6 +26,7 @@
 #include "vast/defaults.hpp"
 #include "vast/detail/make_io_stream.hpp"
 #include "vast/detail/narrow.hpp"
+#include "vast/msgpack_table_slice_builder.hpp"
 #include "vast/table_slice_header.hpp"
 
 #include <caf/sum_type.hpp>
@@ -34,6 +35,7 @@
 #include <arrow/ipc/reader.h>
 #include <arrow/memory_pool.h>
 
+#include <sstream>
 #include <utility>
 
 using caf::get;
@@ -92,4 +94,57 @@ TEST(arrow batch) {
   CHECK_EQUAL(slice_id, zeek_conn_log.size());
 }
 
+TEST(arrow writer to output stream) {
+  auto out = std::make_unique<std::ostringstream>();
+  auto& str = *out;
+  format::arrow::writer writer{std::move(out)};
+  size_t rows = 0;
+  for (auto& slice : zeek_conn_log) {
+    REQUIRE_EQUAL(writer.write(*slice), caf::none);
+    rows += slice->rows();
+  }
+  REQUIRE(writer.flush());
+  auto buf = arrow::Buffer::FromString(str.str());
+  arrow::io::BufferReader input_stream{buf};
+  auto reader_result = arrow::ipc::RecordBatchStreamReader::Open(&input_stream);
+  REQUIRE_OK(reader_result);
+  auto reader = *reader_result;
+  size_t num_rows = 0;
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (reader->ReadNext(&batch).ok() && batch != nullptr)
+    num_rows += detail::narrow<size_t>(batch->num_rows());
+  CHECK_EQUAL(num_rows, rows);
+}
+
+TEST(arrow writer writes pending rows on destruction) {
+  MESSAGE("convert the events to MessagePack to make the writer buffer rows");
+  std::vector<table_slice_ptr> slices;
+  size_t rows = 0;
+  for (auto& slice : zeek_conn_log) {
+    auto builder = msgpack_table_slice_builder::make(slice->layout());
+    for (size_t row = 0; row < slice->rows(); ++row)
+      for (size_t column = 0; column < slice->columns(); ++column)
+        REQUIRE(builder->add(slice->at(row, column)));
+    slices.push_back(builder->finish());
+    rows += slice->rows();
+  }
+  MESSAGE("destroy the writer without flushing");
+  std::stringbuf buf;
+  {
+    format::arrow::writer writer{std::make_unique<std::ostream>(&buf)};
+    for (auto& slice : slices)
+      REQUIRE_EQUAL(writer.write(*slice), caf::none);
+  }
+  auto input = arrow::Buffer::FromString(buf.str());
+  arrow::io::BufferReader input_stream{input};
+  auto reader_result = arrow::ipc::RecordBatchStreamReader::Open(&input_stream);
+  REQUIRE_OK(reader_result);
+  auto reader = *reader_result;
+  size_t num_rows = 0;
+  std::shared_ptr<arrow::RecordBatch> batch;
+  while (reader->ReadNext(&batch).ok() && batch != nullptr)
+    num_rows += detail::narrow<size_t>(batch->num_rows());
+  CHECK_EQUAL(num_rows, rows);
+}
+
 FIXTURE_SCOPE_END()
@@ -344,4 +344,33 @@ TEST(csv reader - line endings) {
   CHECK(slices[0]->at(1, 1) == data{unbox(to<duration>("1days"))});
 }
 
+std::string_view l2_log_invalid = R"__(c,i,r,a
+1,-1,1.5,10.0.0.1
+2,-2,2.5
+3,foo,3.5,10.0.0.3
+4,-4,4.5,10.0.0.4,
+5,-5,,)__";
+
+TEST(csv reader - invalid lines) {
+  auto in = std::make_unique<std::istringstream>(std::string{l2_log_invalid});
+  format::csv::reader reader{defaults::import::table_slice_type, options,
+                             std::move(in)};
+  reader.schema(s);
+  std::vector<table_slice_ptr> slices;
+  auto add_slice = [&](table_slice_ptr ptr) {
+    slices.emplace_back(std::move(ptr));
+  };
+  auto [err, num] = reader.read(5, 5, add_slice);
+  CHECK_EQUAL(err, ec::end_of_input);
+  REQUIRE_EQUAL(num, 2u);
+  REQUIRE_EQUAL(slices.size(), 1u);
+  // Rejected lines must not leave partial rows behind.
+  CHECK(slices[0]->at(0, 0) == data{count{1}});
+  CHECK(slices[0]->at(0, 3) == data{unbox(to<address>("10.0.0.1"))});
+  CHECK(slices[0]->at(1, 0) == data{count{5}});
+  CHECK(slices[0]->at(1, 1) == data{integer{-5}});
+  CHECK(slices[0]->at(1, 2) == data{caf::none});
+  CHECK(slices[0]->at(1, 3) == data{caf::none});
+}
+
 FIXTURE_SCOPE_END()
@@ -20,6 +20,7 @@
 #include "vast/test/fixtures/events.hpp"
 #include "vast/test/test.hpp"
 
+#include "vast/caf_table_slice.hpp"
 #include "vast/caf_table_slice_builder.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/json.hpp"
@@ -109,6 +110,38 @@ TEST(json to data) {
   reference[count{1}] = data{"FOO"};
   reference[count{1024}] = data{"BAR!"};
   CHECK_EQUAL(materialize(ptr->at(0, 17)), data{reference});
+  MESSAGE("the column extractor yields the same values");
+  format::json::field_index index;
+  REQUIRE(index.reset(str));
+  format::json::column_extractor extractor{flat};
+  std::vector<data> row;
+  for (auto i = 0; i < 2; ++i) {
+    REQUIRE_EQUAL(extractor.extract(index, row), caf::none);
+    REQUIRE_EQUAL(row.size(), flat.fields.size());
+    for (size_t column = 0; column < row.size(); ++column)
+      CHECK_EQUAL(make_data_view(row[column]), ptr->at(0, column));
+  }
+}
+
+TEST(json field index) {
+  format::json::field_index xs;
+  REQUIRE(xs.reset(
+    R"({"a": 1, "b": {"c": "x\"y", "d": [1, {"e": 2}]}, "f": null})"));
+  REQUIRE_EQUAL(xs.size(), 5u);
+  CHECK_EQUAL(xs[0].name, "a");
+  CHECK_EQUAL(xs[0].value, "1");
+  CHECK_EQUAL(xs[1].name, "b");
+  CHECK(xs[1].is_object());
+  CHECK_EQUAL(xs[2].name, "b.c");
+  CHECK_EQUAL(xs[2].value, R"("x\"y")");
+  CHECK_EQUAL(xs.find("b.d"), R"([1, {"e": 2}])");
+  CHECK_EQUAL(xs.find("f"), "null");
+  CHECK(xs.find("e").empty());
+  MESSAGE("invalid objects");
+  CHECK(!xs.reset(R"({"a": 1)"));
+  CHECK(!xs.reset(R"([1, 2])"));
+  CHECK(!xs.reset(R"({"a": 1} trailing)"));
+  CHECK(!xs.reset(R"({"a" 1})"));
 }
 
 TEST_DISABLED(suricata) {
@@ -128,6 +161,74 @@ TEST_DISABLED(suricata) {
   CHECK(slices[0]->at(0, 19) == data{count{4520}});
 }
 
+TEST(parallel parsing) {
+  auto layout = record_type{{"c", count_type{}}, {"s", string_type{}}};
+  schema sch;
+  sch.add(layout.name("foo"));
+  std::string input;
+  for (size_t i = 0; i < 1000; ++i)
+    input += R"({"c": )" + std::to_string(i) + R"(, "s": "x"})" + '\n';
+  input += "invalid\n";
+  auto read = [&](size_t threads) {
+    caf::settings opts;
+    caf::put(opts, "import.parse-threads", static_cast<uint64_t>(threads));
+    format::json::reader<> reader{caf_table_slice::class_id, opts,
+                                  std::make_unique<std::istringstream>(input)};
+    REQUIRE_EQUAL(reader.schema(sch), caf::none);
+    std::vector<table_slice_ptr> slices;
+    auto add_slice = [&](table_slice_ptr ptr) {
+      slices.emplace_back(std::move(ptr));
+    };
+    auto [err, num] = reader.read(2000, 100, add_slice);
+    CHECK_EQUAL(err, ec::end_of_input);
+    CHECK_EQUAL(num, 1000u);
+    return slices;
+  };
+  auto xs = read(1);
+  auto ys = read(4);
+  REQUIRE_EQUAL(xs.size(), 10u);
+  REQUIRE_EQUAL(ys.size(), xs.size());
+  for (size_t i = 0; i < xs.size(); ++i)
+    CHECK(*xs[i] == *ys[i]);
+  CHECK_EQUAL(ys[9]->at(99, 0), make_data_view(count{999}));
+}
+
+TEST(parallel parsing with small batches) {
+  auto layout = record_type{{"c", count_type{}}, {"s", string_type{}}};
+  schema sch;
+  sch.add(layout.name("foo"));
+  std::string input;
+  for (size_t i = 0; i < 1000; ++i)
+    input += R"({"c": )" + std::to_string(i) + R"(, "s": "x"})" + '\n';
+  caf::settings opts;
+  caf::put(opts, "import.parse-threads", uint64_t{4});
+  format::json::reader<> reader{caf_table_slice::class_id, opts,
+                                std::make_unique<std::istringstream>(input)};
+  REQUIRE_EQUAL(reader.schema(sch), caf::none);
+  std::vector<table_slice_ptr> slices;
+  auto add_slice = [&](table_slice_ptr ptr) {
+    slices.emplace_back(std::move(ptr));
+  };
+  // The reader parses more lines than requested and hands out the rest in
+  // subsequent calls.
+  size_t total = 0;
+  for (;;) {
+    auto [err, num] = reader.read(150, 100, add_slice);
+    CHECK_LESS_EQUAL(num, 150u);
+    total += num;
+    if (err) {
+      CHECK_EQUAL(err, ec::end_of_input);
+      break;
+    }
+  }
+  CHECK_EQUAL(total, 1000u);
+  size_t expected = 0;
+  for (auto& slice : slices)
+    for (size_t row = 0; row < slice->rows(); ++row)
+      CHECK_EQUAL(slice->at(row, 0), make_data_view(count{expected++}));
+  CHECK_EQUAL(expected, 1000u);
+}
+
 TEST(json hex number parser) {
   using namespace parsers;
   double x;
@@ -130,4 +130,31 @@ TEST(PCAP read/write 2) {
   REQUIRE_EQUAL(writer.write(*slice), caf::none);
 }
 
+TEST(PCAP read with multiple threads) {
+  // Tracking flows in shards must not change which packets pass the cutoff.
+  auto read = [](uint64_t threads) {
+    caf::settings settings;
+    caf::put(settings, "import.pcap.read", artifacts::traces::nmap_vsn);
+    caf::put(settings, "import.pcap.cutoff", static_cast<uint64_t>(64));
+    caf::put(settings, "import.pcap.max-flows", static_cast<size_t>(100));
+    caf::put(settings, "import.parse-threads", threads);
+    format::pcap::reader reader{defaults::import::table_slice_type,
+                                std::move(settings)};
+    std::vector<table_slice_ptr> slices;
+    auto add_slice = [&](const table_slice_ptr& x) { slices.push_back(x); };
+    auto [err, produced] = reader.read(std::numeric_limits<size_t>::max(),
+                                       10, add_slice);
+    CHECK_EQUAL(err, ec::end_of_input);
+    return std::make_pair(produced, std::move(slices));
+  };
+  auto [num_sequential, sequential] = read(1);
+  auto [num_parallel, parallel] = read(4);
+  CHECK_GREATER(num_sequential, 0u);
+  CHECK_LESS(num_sequential, 44u);
+  CHECK_EQUAL(num_parallel, num_sequential);
+  REQUIRE_EQUAL(parallel.size(), sequential.size());
+  for (size_t i = 0; i < sequential.size(); ++i)
+    CHECK(*parallel[i] == *sequential[i]);
+}
+
 FIXTURE_SCOPE_END()
@@ -248,6 +248,9 @@ TEST(zeek data parsing) {
   CHECK(d == ts);
   CHECK(zeek_parse(string_type{}, "\\x2afoo*"s, d));
   CHECK(d == "*foo*");
+  CHECK(zeek_parse(string_type{}, "bar"s, d));
+  CHECK(d == "bar");
+  CHECK(!zeek_parse(string_type{}, ""s, d));
   CHECK(zeek_parse(address_type{}, "192.168.1.103", d));
   CHECK(d == *to<address>("192.168.1.103"));
   CHECK(zeek_parse(subnet_type{}, "10.0.0.0/24", d));
@@ -49,6 +49,23 @@ TEST(string) {
   CHECK_EQUAL(to_string(unbox(result)), "01101000101");
 }
 
+TEST(batched lookup) {
+  hash_index<1> idx{string_type{}};
+  auto ys = std::vector<std::string>{"foo", "bar", "baz", "foo", "qux", "bar"};
+  for (auto& y : ys)
+    REQUIRE(idx.append(make_data_view(y)));
+  REQUIRE(idx.append(make_data_view(caf::none)));
+  auto xs = std::vector<data_view>{make_data_view("foo"), make_data_view("baz"),
+                                   make_data_view("corge"),
+                                   make_data_view("foo")};
+  for (auto op : {equal, not_equal}) {
+    auto hits = unbox(idx.lookup_batch(op, xs));
+    REQUIRE_EQUAL(hits.size(), xs.size());
+    for (size_t i = 0; i < xs.size(); ++i)
+      CHECK_EQUAL(hits[i], unbox(idx.lookup(op, xs[i])));
+  }
+}
+
 TEST(serialization) {
   hash_index<1> x{string_type{}};
   REQUIRE(x.append(make_data_view("foo")));
@@ -64,6 +81,35 @@ TEST(serialization) {
   CHECK(!y.append(make_data_view("foo")));
 }
 
+// A deserialized index answers lookups with a binary search over its sorted
+// digests, which must yield the same results as the scan.
+TEST(sealed lookup) {
+  hash_index<2> x{string_type{}};
+  auto xs = std::vector<std::string>{"foo", "bar", "baz", "foo", "qux", "bar"};
+  for (auto& str : xs)
+    REQUIRE(x.append(make_data_view(str)));
+  REQUIRE(x.append(make_data_view(caf::none)));
+  REQUIRE(x.append(make_data_view("foo"), 10));
+  std::vector<char> buf;
+  REQUIRE(save(nullptr, buf, x) == caf::none);
+  hash_index<2> y{string_type{}};
+  REQUIRE(load(nullptr, buf, y) == caf::none);
+  xs.emplace_back("corge");
+  for (auto& str : xs) {
+    auto rhs = make_data_view(str);
+    CHECK_EQUAL(unbox(y.lookup(equal, rhs)), unbox(x.lookup(equal, rhs)));
+    CHECK_EQUAL(unbox(y.lookup(not_equal, rhs)),
+                unbox(x.lookup(not_equal, rhs)));
+  }
+  CHECK_EQUAL(to_string(unbox(y.lookup(equal, make_data_view("foo")))),
+              "10010000001");
+  auto ys = list{"foo", "qux", "foo"};
+  CHECK_EQUAL(to_string(unbox(y.lookup(in, make_data_view(ys)))),
+              "10011000001");
+  CHECK_EQUAL(to_string(unbox(y.lookup(not_in, make_data_view(ys)))),
+              "01100100000");
+}
+
 // The attribute #index=hash selects the hash_index implementation.
 TEST(factory construction and parameterization) {
   factory<value_index>::initialize();
@@ -196,6 +196,13 @@ TEST(printable) {
   std::string str;
   CHECK(printers::json<policy::tree>(str, json{o}));
   CHECK_EQUAL(str, json_tree);
+  MESSAGE("escaping");
+  CHECK_EQUAL(to_string(json{"a \"quoted\" string with\ttab"}),
+              R"("a \"quoted\" string with\ttab")");
+  CHECK_EQUAL(to_string(json{"0123456789abcdef\\0123456789\x01"}),
+              R"("0123456789abcdef\\0123456789\u0001")");
+  CHECK_EQUAL(to_string(json{"\xc3\xa4 is not a control character"}),
+              "\"\xc3\xa4 is not a control character\"");
 }
 
 TEST(combination) {
@@ -255,6 +255,57 @@ TEST(meta index with bool synopsis) {
   CHECK_EQUAL(lookup("y != T"), all);
 }
 
+TEST(meta index with string synopsis) {
+  MESSAGE("add layouts with and without string synopsis");
+  factory<synopsis>::initialize();
+  meta_index meta_idx;
+  put(meta_idx.factory_options(), "max-partition-size", 1000);
+  auto hash = string_type{}.attributes({{"index", "hash"}});
+  auto hashed = record_type{{"community_id", hash}, {"state", hash}}.name(
+    "suricata.flow");
+  auto plain = record_type{{"community_id", string_type{}},
+                           {"conn_state", string_type{}}}
+                 .name("zeek.conn");
+  auto make_slice = [](const record_type& layout, std::string_view x,
+                       std::string_view y) {
+    auto builder = caf_table_slice_builder::make(layout);
+    CHECK(builder->add(make_data_view(x)));
+    CHECK(builder->add(make_data_view(y)));
+    auto slice = builder->finish();
+    REQUIRE(slice != nullptr);
+    return slice;
+  };
+  // The first partition only holds the layout with synopses, the second one
+  // only the layout without, and the third one holds both.
+  auto id1 = uuid::random();
+  meta_idx.add(id1, *make_slice(hashed, "1:foo", "S0"));
+  auto id2 = uuid::random();
+  meta_idx.add(id2, *make_slice(plain, "1:bar", "S1"));
+  auto id3 = uuid::random();
+  meta_idx.add(id3, *make_slice(hashed, "1:baz", "S2"));
+  meta_idx.add(id3, *make_slice(plain, "1:qux", "S3"));
+  auto lookup = [&](std::string_view expr) {
+    auto result = meta_idx.lookup(unbox(to<expression>(expr)));
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+  auto sorted = [](std::vector<uuid> xs) {
+    std::sort(xs.begin(), xs.end());
+    return xs;
+  };
+  MESSAGE("fields without synopsis never prune partitions");
+  auto all = sorted({id1, id2, id3});
+  CHECK_EQUAL(lookup("community_id == \"1:foo\""), all);
+  CHECK_EQUAL(lookup("community_id == \"1:bar\""), sorted({id2, id3}));
+  CHECK_EQUAL(lookup("community_id in [\"1:bar\", \"1:qux\"]"),
+              sorted({id2, id3}));
+  CHECK_EQUAL(lookup("community_id in [\"1:foo\", \"1:baz\"]"), all);
+  MESSAGE("suffix matches include fields without synopsis");
+  CHECK_EQUAL(lookup("state == \"S0\""), all);
+  CHECK_EQUAL(lookup("state == \"S1\""), sorted({id2, id3}));
+  CHECK_EQUAL(lookup("suricata.flow.state == \"S1\""), std::vector<uuid>{});
+}
+
 TEST(option setting and retrieval) {
   meta_index meta_idx;
   auto& opts = meta_idx.factory_options();
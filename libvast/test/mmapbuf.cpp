@@ -15,10 +15,14 @@
 #include "vast/test/test.hpp"
 #include "vast/test/fixtures/filesystem.hpp"
 
+#include "vast/detail/line_range.hpp"
 #include "vast/detail/mmapbuf.hpp"
 
 #include <fstream>
+#include <istream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "vast/si_literals.hpp"
 
@@ -104,4 +108,26 @@ TEST(memory-mapped streambuffer aligned resize large) {
   aligned_resize_test_impl(filename, size);
 }
 
+TEST(memory-mapped line range) {
+  auto filename = directory / "lines.txt";
+  std::ofstream ofs{filename.str()};
+  ofs << "foo\n\nbar\r\nbaz\rqux";
+  ofs.close();
+  auto sb = detail::mmapbuf::map_readonly(filename);
+  REQUIRE(sb != nullptr);
+  std::istream in{sb.get()};
+  detail::line_range lines{in};
+  std::vector<std::pair<std::string, size_t>> xs;
+  for (lines.next(); !lines.done(); lines.next()) {
+    CHECK(lines.get() == lines.view());
+    xs.emplace_back(std::string{lines.view()}, lines.line_number());
+  }
+  decltype(xs) expected{{"foo", 1}, {"bar", 3}, {"baz", 4}, {"qux", 5}};
+  CHECK_EQUAL(xs, expected);
+  MESSAGE("refuse to map empty files");
+  auto empty = directory / "empty.txt";
+  std::ofstream{empty.str()}.close();
+  CHECK(detail::mmapbuf::map_readonly(empty) == nullptr);
+}
+
 FIXTURE_SCOPE_END()
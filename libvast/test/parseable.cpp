@@ -31,6 +31,7 @@
 #include <caf/test/dsl.hpp>
 
 #include <array>
+#include <cmath>
 #include <map>
 #include <string>
 #include <type_traits>
@@ -586,6 +587,13 @@ TEST(real) {
   CHECK(p(f, l, d));
   CHECK(d == -0.456789);
   CHECK(f == l);
+  MESSAGE("UNIX timestamp with microseconds");
+  str = "1258531221.486539";
+  f = str.begin();
+  l = str.end();
+  CHECK(p(f, l, d));
+  CHECK(d == 1258531221 + 486539 / std::pow(10.0, 6));
+  CHECK(f == l);
   //  MESSAGE("no fractional part, negative");
   //  d = 0;
   //  f = str.begin();
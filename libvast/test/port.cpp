@@ -62,4 +62,8 @@ TEST(parseable) {
   CHECK(x == port{7, port::icmp6});
   CHECK(parsers::port("80/sctp"s, x));
   CHECK(x == port{80, port::sctp});
+  CHECK(!parsers::port("80/"s, x));
+  CHECK(!parsers::port("80/icm"s, x));
+  CHECK(!parsers::port("80/tcpx"s, x));
+  CHECK(!parsers::port("80/TCP"s, x));
 }
@@ -18,16 +18,63 @@
 #include "vast/test/fixtures/events.hpp"
 #include "vast/test/test.hpp"
 
+#include "vast/fbs/segment.hpp"
+#include "vast/fbs/utils.hpp"
 #include "vast/ids.hpp"
 #include "vast/load.hpp"
 #include "vast/save.hpp"
 #include "vast/segment_builder.hpp"
 #include "vast/table_slice.hpp"
 
+#include <caf/binary_serializer.hpp>
 #include <caf/test/dsl.hpp>
 
 using namespace vast;
 
+namespace {
+
+// Builds a segment of version v0, in which every table slice contains its
+// complete CAF serialization including the layout.
+segment make_v0_segment(const std::vector<table_slice_ptr>& slices) {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<fbs::TableSliceBuffer>> flat_slices;
+  std::vector<fbs::Interval> intervals;
+  uint64_t events = 0;
+  for (auto x : slices) {
+    flatbuffers::FlatBufferBuilder local_builder;
+    std::vector<char> buffer;
+    caf::binary_serializer sink{nullptr, buffer};
+    REQUIRE_EQUAL(sink(x), caf::none);
+    auto ptr = reinterpret_cast<const uint8_t*>(buffer.data());
+    auto data = local_builder.CreateVector(ptr, buffer.size());
+    fbs::TableSliceBuilder table_slice_builder{local_builder};
+    table_slice_builder.add_offset(x->offset());
+    table_slice_builder.add_rows(x->rows());
+    table_slice_builder.add_data(data);
+    local_builder.Finish(table_slice_builder.Finish());
+    auto bytes = builder.CreateVector(local_builder.GetBufferPointer(),
+                                      local_builder.GetSize());
+    fbs::TableSliceBufferBuilder table_slice_buffer_builder{builder};
+    table_slice_buffer_builder.add_data(bytes);
+    flat_slices.push_back(table_slice_buffer_builder.Finish());
+    intervals.emplace_back(x->offset(), x->offset() + x->rows());
+    events += x->rows();
+  }
+  auto slices_offset = builder.CreateVector(flat_slices);
+  auto uuid_offset = fbs::pack_bytes(builder, uuid::random());
+  auto ids_offset = builder.CreateVectorOfStructs(intervals);
+  fbs::SegmentBuilder segment_builder{builder};
+  segment_builder.add_version(fbs::Version::v0);
+  segment_builder.add_slices(slices_offset);
+  segment_builder.add_uuid(uuid_offset);
+  segment_builder.add_ids(ids_offset);
+  segment_builder.add_events(events);
+  fbs::FinishSegmentBuffer(builder, segment_builder.Finish());
+  return unbox(segment::make(fbs::release(builder)));
+}
+
+} // namespace
+
 FIXTURE_SCOPE(segment_tests, fixtures::events)
 
 TEST(construction and querying) {
@@ -44,6 +91,37 @@ TEST(construction and querying) {
   CHECK_EQUAL(*slices[1], *zeek_conn_log[2]);
 }
 
+TEST(shared layouts) {
+  segment_builder builder;
+  for (auto& slice : zeek_conn_log)
+    REQUIRE(!builder.add(slice));
+  for (auto& slice : zeek_dns_log)
+    REQUIRE(!builder.add(slice));
+  auto x = builder.finish();
+  MESSAGE("store every layout once");
+  auto ptr = fbs::GetSegment(x.chunk()->data());
+  CHECK(ptr->version() == fbs::Version::v1);
+  REQUIRE_NOT_EQUAL(ptr->layouts(), nullptr);
+  CHECK_EQUAL(ptr->layouts()->size(), 2u);
+  MESSAGE("restore the layouts of table slices");
+  auto slices = unbox(x.lookup(make_ids({0, 8, 20})));
+  REQUIRE_EQUAL(slices.size(), 3u);
+  CHECK_EQUAL(*slices[0], *zeek_conn_log[0]);
+  CHECK_EQUAL(*slices[1], *zeek_conn_log[1]);
+  CHECK_EQUAL(*slices[2], *zeek_dns_log[0]);
+  CHECK_EQUAL(slices[2]->layout(), zeek_dns_log[0]->layout());
+}
+
+TEST(version v0) {
+  auto x = make_v0_segment(zeek_conn_log);
+  CHECK_EQUAL(x.num_slices(), zeek_conn_log.size());
+  auto slices = unbox(x.lookup(make_ids({0, 6, 19, 21})));
+  REQUIRE_EQUAL(slices.size(), 2u);
+  CHECK_EQUAL(*slices[0], *zeek_conn_log[0]);
+  CHECK_EQUAL(*slices[1], *zeek_conn_log[2]);
+  CHECK_EQUAL(slices[1]->layout(), zeek_conn_log[2]->layout());
+}
+
 TEST(serialization) {
   segment_builder builder;
   auto slice = zeek_conn_log[0];
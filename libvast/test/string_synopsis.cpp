@@ -0,0 +1,83 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE string_synopsis
+
+#include "vast/string_synopsis.hpp"
+
+#include <vast/concept/hashable/hash_append.hpp>
+#include <vast/concept/hashable/xxhash.hpp>
+#include <vast/load.hpp>
+#include <vast/save.hpp>
+#include <vast/si_literals.hpp>
+#include <vast/synopsis.hpp>
+#include <vast/synopsis_factory.hpp>
+#include <vast/test/fixtures/actor_system.hpp>
+#include <vast/test/synopsis.hpp>
+#include <vast/test/test.hpp>
+#include <vast/type.hpp>
+
+using namespace std::string_literals;
+using namespace vast;
+using namespace vast::test;
+using namespace vast::si_literals;
+
+TEST(no synopsis for regular strings) {
+  caf::settings opts;
+  opts["max-partition-size"] = 1_Mi;
+  auto x = make_string_synopsis<xxhash64>(string_type{}, opts);
+  CHECK_EQUAL(x, nullptr);
+}
+
+namespace {
+
+struct fixture : fixtures::deterministic_actor_system {
+  fixture() {
+    factory<synopsis>::add(string_type{}, make_string_synopsis<xxhash64>);
+  }
+  caf::settings opts;
+};
+
+} // namespace
+
+FIXTURE_SCOPE(string_synopsis_tests, fixture)
+
+TEST(lookup) {
+  using namespace nft;
+  auto t = string_type{}.attributes({{"synopsis", "bloomfilter(100,0.001)"}});
+  auto x = factory<synopsis>::make(t, opts);
+  REQUIRE_NOT_EQUAL(x, nullptr);
+  x->add(make_data_view("CHhAvVGS1DHFjwGM9"));
+  auto verify = verifier{x};
+  verify(make_data_view("CHhAvVGS1DHFjwGM9"),
+         {N, N, N, N, N, N, T, N, N, N, N, N});
+  verify(make_data_view("ClEkJM2Vm5giqnMf4h"),
+         {N, N, N, N, N, N, F, N, N, N, N, N});
+  MESSAGE("membership in a list of keys");
+  auto hit = list{"ClEkJM2Vm5giqnMf4h", "CHhAvVGS1DHFjwGM9"};
+  auto miss = list{"ClEkJM2Vm5giqnMf4h", "C4J4Th3PJpwUYZZ6gc"};
+  CHECK_EQUAL(x->lookup(in, make_view(hit)), T);
+  CHECK_EQUAL(x->lookup(in, make_view(miss)), F);
+  MESSAGE("predicates with other types are never pruned");
+  CHECK_EQUAL(x->lookup(equal, make_data_view(integer{42})), N);
+}
+
+TEST(construction based on partition size) {
+  opts["max-partition-size"] = 1_Mi;
+  auto t = string_type{}.attributes({{"index", "hash"}});
+  auto ptr = factory<synopsis>::make(t, opts);
+  REQUIRE_NOT_EQUAL(ptr, nullptr);
+  CHECK_ROUNDTRIP_DEREF(ptr);
+}
+
+FIXTURE_SCOPE_END()
@@ -0,0 +1,71 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#define SUITE batch_size_controller
+
+#include "vast/system/batch_size_controller.hpp"
+
+#include "vast/test/test.hpp"
+
+#include <chrono>
+
+using namespace vast;
+using namespace vast::system;
+using namespace std::chrono_literals;
+
+TEST(fixed size) {
+  batch_size_controller x{100};
+  CHECK(!x.adaptive());
+  x.observe(1'000'000, 1s, 1, false);
+  CHECK_EQUAL(x.size(), 100u);
+  x.observe(1, 1s, 10, true);
+  CHECK_EQUAL(x.size(), 100u);
+}
+
+TEST(grow with event rate) {
+  batch_size_controller x{10, 1000, 1s};
+  CHECK(x.adaptive());
+  CHECK_EQUAL(x.size(), 10u);
+  // The size at most doubles per observation.
+  x.observe(10'000, 1s, 10, false);
+  CHECK_EQUAL(x.size(), 20u);
+  for (auto i = 0; i < 10; ++i)
+    x.observe(10'000, 1s, 10, false);
+  CHECK_EQUAL(x.size(), 1000u);
+}
+
+TEST(shrink with event rate) {
+  batch_size_controller x{10, 1000, 1s};
+  for (auto i = 0; i < 10; ++i)
+    x.observe(10'000, 1s, 10, false);
+  REQUIRE_EQUAL(x.size(), 1000u);
+  // A slow input that hits the batch timeout shrinks the table slices until
+  // they fill up within the target latency.
+  for (auto i = 0; i < 50; ++i)
+    x.observe(50, 1s, 10, true);
+  CHECK_EQUAL(x.size(), 50u);
+  for (auto i = 0; i < 20; ++i)
+    x.observe(1, 1s, 10, true);
+  CHECK_EQUAL(x.size(), 10u);
+}
+
+TEST(grow with backpressure) {
+  batch_size_controller x{10, 1000, 1s};
+  x.observe(10, 1s, 10, false);
+  CHECK_EQUAL(x.size(), 10u);
+  // Sinks asking for a single table slice at a time fall behind.
+  x.observe(10, 1s, 1, false);
+  CHECK_EQUAL(x.size(), 20u);
+  x.observe(20, 1s, 1, false);
+  CHECK_EQUAL(x.size(), 40u);
+}
@@ -64,7 +64,15 @@ ids select(const counts& xs, curried_predicate pred) {
 // Dummy actor representing an INDEXER for field `x`.
 caf::behavior dummy_indexer(counts xs) {
   return {
-    [xs = std::move(xs)](curried_predicate pred) { return select(xs, pred); }};
+    [xs](curried_predicate pred) { return select(xs, pred); },
+    [xs](const std::vector<curried_predicate>& preds) {
+      std::vector<ids> result;
+      for (auto& pred : preds)
+        result.push_back(select(xs, pred));
+      std::vector<caf::error> errors(preds.size());
+      return caf::make_message(std::move(result), std::move(errors));
+    },
+  };
 }
 
 struct fixture : fixtures::deterministic_actor_system_and_events {
@@ -171,4 +179,11 @@ TEST(disjunctions) {
   CHECK_QUERY("x == 75 || y == 77", ({3, 5}));
 }
 
+TEST(batched predicates) {
+  MESSAGE("multiple predicates for the same INDEXER");
+  CHECK_QUERY("x == 13 || x == 75", ({1, 5}));
+  CHECK_QUERY("x == 42 && x != 12", ({{0, 5}}));
+  CHECK_QUERY("(x == 13 || x == 75) && y == 42", ({1}));
+}
+
 FIXTURE_SCOPE_END()
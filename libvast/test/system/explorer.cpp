@@ -13,15 +13,37 @@
 
 #define SUITE explorer
 
+#include "vast/test/fixtures/actor_system.hpp"
 #include "vast/test/test.hpp"
 
+#include "vast/caf_table_slice_builder.hpp"
+#include "vast/system/explorer.hpp"
 #include "vast/system/spawn_explorer.hpp"
+#include "vast/table_slice.hpp"
 #include "vast/time.hpp"
 
 #include <caf/settings.hpp>
+#include <caf/stateful_actor.hpp>
 
 using namespace std::chrono_literals;
 
+namespace {
+
+struct collector_state {
+  std::vector<vast::table_slice_ptr> slices;
+  static inline constexpr const char* name = "collector";
+};
+
+using collector_actor = caf::stateful_actor<collector_state>;
+
+caf::behavior collector(collector_actor* self) {
+  return {[=](vast::table_slice_ptr slice) {
+    self->state.slices.push_back(std::move(slice));
+  }};
+}
+
+} // namespace
+
 TEST(explorer config) {
   {
     MESSAGE("Specifying no options at all is not allowed.");
@@ -68,3 +90,89 @@ TEST(explorer config) {
     CHECK_EQUAL(vast::system::explorer_validate_args(settings), caf::none);
   }
 }
+
+TEST(explorer batched query) {
+  using vast::system::explorer_state;
+  explorer_state st{nullptr};
+  st.before = vast::duration{10s};
+  st.after = vast::duration{10s};
+  st.by = "foo";
+  auto t0 = vast::time{} + 1h;
+  explorer_state::seed_map seeds;
+  seeds[vast::data{"a"}] = {{t0}, {t0 + 15s}};
+  seeds[vast::data{"b"}] = {{t0 + 1min}};
+  auto expr = st.make_query(seeds);
+  auto conj = caf::get_if<vast::conjunction>(&expr);
+  REQUIRE(conj);
+  REQUIRE_EQUAL(conj->size(), 2u);
+  MESSAGE("overlapping time boxes get merged");
+  auto timeboxes = caf::get_if<vast::disjunction>(&conj->at(0));
+  REQUIRE(timeboxes);
+  REQUIRE_EQUAL(timeboxes->size(), 2u);
+  auto first = caf::get_if<vast::conjunction>(&timeboxes->at(0));
+  REQUIRE(first);
+  auto lower = caf::get_if<vast::predicate>(&first->at(0));
+  auto upper = caf::get_if<vast::predicate>(&first->at(1));
+  REQUIRE(lower && upper);
+  CHECK_EQUAL(caf::get<vast::data>(lower->rhs), vast::data{t0 - 10s});
+  CHECK_EQUAL(caf::get<vast::data>(upper->rhs), vast::data{t0 + 25s});
+  MESSAGE("the values of the by field become a list");
+  auto by = caf::get_if<vast::predicate>(&conj->at(1));
+  REQUIRE(by);
+  CHECK_EQUAL(by->op, vast::in);
+  auto values = caf::get_if<vast::list>(&caf::get<vast::data>(by->rhs));
+  REQUIRE(values);
+  CHECK_EQUAL(values->size(), 2u);
+}
+
+FIXTURE_SCOPE(explorer_tests, fixtures::deterministic_actor_system)
+
+TEST(explorer forward context) {
+  using vast::system::explorer_state;
+  using explorer_actor = caf::stateful_actor<explorer_state>;
+  auto limits = explorer_state::event_limits{100, 1};
+  auto exp = sys.spawn(vast::system::explorer, caf::actor{}, limits,
+                       vast::duration{10s}, vast::duration{10s},
+                       std::string{"foo"});
+  auto sink = sys.spawn(collector);
+  run();
+  auto& st = deref<explorer_actor>(exp).state;
+  st.sink = sink;
+  auto t0 = vast::time{} + 1h;
+  explorer_state::seed_map seeds;
+  seeds[vast::data{"a"}] = {{t0}, {t0 + 15s}};
+  seeds[vast::data{"b"}] = {{t0 + 1min}};
+  auto layout = vast::record_type{
+    {"ts", vast::time_type{}.attributes({{"timestamp"}})},
+    {"foo", vast::string_type{}},
+  }.name("test");
+  auto builder = vast::caf_table_slice_builder::make(layout);
+  auto add = [&](vast::time ts, std::string_view foo) {
+    CHECK(builder->add(vast::make_data_view(ts)));
+    CHECK(builder->add(vast::make_data_view(foo)));
+  };
+  add(t0, "a");         // context of the first seed of a
+  add(t0 + 1s, "a");    // the first seed of a reached its limit
+  add(t0 + 5s, "b");    // outside the time box of b
+  add(t0 + 1min, "b");  // context of the seed of b
+  add(t0 + 1min, "a");  // outside the time boxes of a
+  add(t0 + 20s, "a");   // context of the second seed of a
+  auto slice = builder->finish();
+  REQUIRE(slice != nullptr);
+  slice.unshared().offset(0);
+  st.forward_context(seeds, slice);
+  run();
+  std::vector<vast::id> ids;
+  for (auto& x : deref<collector_actor>(sink).state.slices)
+    for (size_t row = 0; row < x->rows(); ++row)
+      ids.push_back(x->offset() + row);
+  CHECK_EQUAL(ids, (std::vector<vast::id>{0, 3, 5}));
+  CHECK_EQUAL(seeds[vast::data{"a"}][0].num_results, 1u);
+  CHECK_EQUAL(seeds[vast::data{"a"}][1].num_results, 1u);
+  CHECK_EQUAL(seeds[vast::data{"b"}][0].num_results, 1u);
+  self->send_exit(exp, caf::exit_reason::user_shutdown);
+  self->send_exit(sink, caf::exit_reason::user_shutdown);
+  run();
+}
+
+FIXTURE_SCOPE_END()
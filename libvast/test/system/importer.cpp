@@ -95,7 +95,8 @@ struct importer_fixture : Base {
     bf::reader reader{vast::defaults::import::table_slice_type, caf::settings{},
                       std::move(stream)};
     return this->self->spawn(system::source<bf::reader>, std::move(reader),
-                             slice_size, caf::none,
+                             system::batch_size_controller{slice_size},
+                             caf::none,
                              vast::system::type_registry_type{}, vast::schema{},
                              std::string{}, vast::system::accountant_type{});
   }
@@ -136,4 +136,32 @@ TEST(integer rows) {
   verify();
 }
 
+TEST(batched predicates with errors) {
+  MESSAGE("ingest integer events");
+  integer_type column_type;
+  record_type layout{{"value", column_type}};
+  auto rows = make_rows(1, 2, 3, 1, 2, 3, 1, 2, 3);
+  num_ids = rows.size();
+  ingest({caf_table_slice::make(layout, rows)});
+  MESSAGE("send a batch with a type clash in the middle");
+  std::vector<curried_predicate> preds;
+  for (auto what : {":int == +1", ":int == \"foo\"", ":int == +3"})
+    preds.push_back(curried(unbox(to<predicate>(what))));
+  self->send(indexer, std::move(preds));
+  run();
+  MESSAGE("only the failing predicate has no result");
+  self->receive(
+    [&](std::vector<ids>& hits, const std::vector<caf::error>& errors) {
+      REQUIRE_EQUAL(hits.size(), 3u);
+      REQUIRE_EQUAL(errors.size(), 3u);
+      CHECK(!errors[0]);
+      CHECK(errors[1]);
+      CHECK(!errors[2]);
+      align(hits[0], res());
+      align(hits[2], res());
+      CHECK_EQUAL(hits[0], res(0u, 3u, 6u));
+      CHECK_EQUAL(hits[2], res(2u, 5u, 8u));
+    });
+}
+
 FIXTURE_SCOPE_END()
@@ -68,7 +68,7 @@ TEST(zeek source) {
                               caf::settings{}, std::move(stream)};
   MESSAGE("start source for producing table slices of size 10");
   auto src = self->spawn(source<format::zeek::reader>, std::move(reader),
-                         events::slice_size, caf::none,
+                         batch_size_controller{events::slice_size}, caf::none,
                          vast::system::type_registry_type{}, vast::schema{},
                          std::string{}, vast::system::accountant_type{});
   run();
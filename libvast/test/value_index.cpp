@@ -18,6 +18,7 @@
 #include "vast/test/fixtures/events.hpp"
 #include "vast/test/test.hpp"
 
+#include "vast/chunk.hpp"
 #include "vast/concept/parseable/to.hpp"
 #include "vast/concept/parseable/vast/address.hpp"
 #include "vast/concept/parseable/vast/data.hpp"
@@ -25,6 +26,8 @@
 #include "vast/concept/parseable/vast/time.hpp"
 #include "vast/concept/printable/to_string.hpp"
 #include "vast/concept/printable/vast/bitmap.hpp"
+#include "vast/defaults.hpp"
+#include "vast/fbs/utils.hpp"
 #include "vast/load.hpp"
 #include "vast/save.hpp"
 #include "vast/table_slice.hpp"
@@ -271,6 +274,65 @@ TEST(string) {
   CHECK_EQUAL(to_string(unbox(result)), "0100010000");
 }
 
+TEST(dictionary) {
+  auto t = string_type{}.attributes({{"index", "dictionary"}});
+  caf::settings opts;
+  opts["max-dictionary-size"] = 4;
+  auto idx = factory<value_index>::make(t, opts);
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  auto dict = dynamic_cast<dictionary_index*>(idx.get());
+  REQUIRE_NOT_EQUAL(dict, nullptr);
+  MESSAGE("append");
+  REQUIRE(idx->append(make_data_view("tcp")));
+  REQUIRE(idx->append(make_data_view("udp")));
+  REQUIRE(idx->append(make_data_view("tcp")));
+  REQUIRE(idx->append(make_data_view(caf::none)));
+  REQUIRE(idx->append(make_data_view("icmp")));
+  REQUIRE(idx->append(make_data_view("")));
+  CHECK_EQUAL(dict->cardinality(), 4u);
+  CHECK(!dict->is_fallback());
+  MESSAGE("lookup");
+  auto result = idx->lookup(equal, make_data_view("tcp"));
+  CHECK_EQUAL(to_string(unbox(result)), "101000");
+  result = idx->lookup(not_equal, make_data_view("tcp"));
+  CHECK_EQUAL(to_string(unbox(result)), "010111");
+  result = idx->lookup(equal, make_data_view("sctp"));
+  CHECK_EQUAL(to_string(unbox(result)), "000000");
+  result = idx->lookup(equal, make_data_view(""));
+  CHECK_EQUAL(to_string(unbox(result)), "000001");
+  result = idx->lookup(ni, make_data_view("cp"));
+  CHECK_EQUAL(to_string(unbox(result)), "101010");
+  auto xs = list{"udp", "icmp"};
+  result = idx->lookup(in, make_data_view(xs));
+  CHECK_EQUAL(to_string(unbox(result)), "010010");
+  MESSAGE("serialization");
+  std::vector<char> buf;
+  CHECK_EQUAL(save(nullptr, buf, idx), caf::none);
+  value_index_ptr idx2;
+  CHECK_EQUAL(load(nullptr, buf, idx2), caf::none);
+  REQUIRE_NOT_EQUAL(idx2, nullptr);
+  result = idx2->lookup(equal, make_data_view("udp"));
+  CHECK_EQUAL(to_string(unbox(result)), "010000");
+  MESSAGE("fallback to string index");
+  REQUIRE(idx->append(make_data_view("sctp")));
+  REQUIRE(idx->append(make_data_view("tcp")));
+  CHECK(dict->is_fallback());
+  CHECK_EQUAL(dict->cardinality(), 0u);
+  result = idx->lookup(equal, make_data_view("tcp"));
+  CHECK_EQUAL(to_string(unbox(result)), "10100001");
+  result = idx->lookup(equal, make_data_view("sctp"));
+  CHECK_EQUAL(to_string(unbox(result)), "00000010");
+  result = idx->lookup(equal, make_data_view(caf::none));
+  CHECK_EQUAL(to_string(unbox(result)), "00010000");
+  result = idx->lookup(ni, make_data_view("cp"));
+  CHECK_EQUAL(to_string(unbox(result)), "10101011");
+  buf.clear();
+  CHECK_EQUAL(save(nullptr, buf, idx), caf::none);
+  CHECK_EQUAL(load(nullptr, buf, idx2), caf::none);
+  result = idx2->lookup(equal, make_data_view("icmp"));
+  CHECK_EQUAL(to_string(unbox(result)), "00001000");
+}
+
 TEST(address) {
   address_index idx{address_type{}};
   MESSAGE("append");
@@ -324,6 +386,44 @@ TEST(address) {
   auto xs = list{*to<address>("192.168.0.1"), *to<address>("192.168.0.2")};
   auto multi = unbox(idx.lookup(in, make_data_view(xs)));
   CHECK_EQUAL(to_string(multi), "11011100000");
+  MESSAGE("batched lookup");
+  auto a = *to<address>("192.168.0.1");
+  auto b = *to<address>("10.0.0.1");
+  auto c = *to<address>("192.168.0.2");
+  auto batch = std::vector<data_view>{make_data_view(a), make_data_view(b),
+                                      make_data_view(c), make_data_view(a),
+                                      make_data_view(caf::none)};
+  auto hits = unbox(idx.lookup_batch(equal, batch));
+  REQUIRE_EQUAL(hits.size(), 5u);
+  CHECK_EQUAL(to_string(hits[0]), "10011000000");
+  CHECK_EQUAL(to_string(hits[1]), "00000000000");
+  CHECK_EQUAL(to_string(hits[2]), "01000100000");
+  CHECK_EQUAL(to_string(hits[3]), "10011000000");
+  CHECK_EQUAL(to_string(hits[4]), "00000000000");
+  hits = unbox(idx.lookup_batch(not_equal, batch));
+  CHECK_EQUAL(to_string(hits[0]), "01100111111");
+  CHECK_EQUAL(to_string(hits[1]), "11111111111");
+  MESSAGE("batched subnet membership");
+  auto subnets = std::vector<subnet>{
+    {*to<address>("192.168.0.128"), 25}, {*to<address>("192.168.0.0"), 24},
+    {*to<address>("10.0.0.0"), 8}, {*to<address>("192.168.0.64"), 26},
+    {*to<address>("192.168.0.0"), 30}};
+  batch.clear();
+  for (auto& sn : subnets)
+    batch.push_back(make_data_view(sn));
+  hits = unbox(idx.lookup_batch(in, batch));
+  REQUIRE_EQUAL(hits.size(), 5u);
+  CHECK_EQUAL(to_string(hits[0]), "00000011100");
+  CHECK_EQUAL(to_string(hits[1]), "11111111111");
+  CHECK_EQUAL(to_string(hits[2]), "00000000000");
+  CHECK_EQUAL(to_string(hits[3]), "00000000010");
+  CHECK_EQUAL(to_string(hits[4]), "11111100000");
+  hits = unbox(idx.lookup_batch(not_in, batch));
+  for (size_t i = 0; i < batch.size(); ++i)
+    CHECK_EQUAL(hits[i], unbox(idx.lookup(not_in, batch[i])));
+  auto subnet_list = list{subnets[0], subnets[4]};
+  bm = idx.lookup(in, make_data_view(subnet_list));
+  CHECK_EQUAL(to_string(unbox(bm)), "11111111100");
   MESSAGE("gaps");
   x = *to<address>("192.168.0.2");
   CHECK(idx.append(make_data_view(x), 42));
@@ -520,6 +620,76 @@ TEST(none values - arithmetic) {
   CHECK_EQUAL(to_string(unbox(bm)), "00100");
 }
 
+TEST(flatbuffers) {
+  auto roundtrip = [](const value_index_ptr& idx) {
+    auto chk = unbox(fbs::wrap(idx, fbs::file_identifier));
+    value_index_ptr result;
+    REQUIRE_EQUAL(fbs::unwrap<fbs::ValueIndex>(as_bytes(chk), result),
+                  caf::none);
+    REQUIRE_NOT_EQUAL(result, nullptr);
+    CHECK_EQUAL(result->offset(), idx->offset());
+    CHECK_EQUAL(result->type(), idx->type());
+    return result;
+  };
+  auto check = [&](const type& t, const std::vector<data>& xs,
+                   relational_operator op, const data& rhs) {
+    MESSAGE("checking " << t);
+    auto idx = factory<value_index>::make(t, caf::settings{});
+    REQUIRE_NOT_EQUAL(idx, nullptr);
+    for (auto& x : xs)
+      REQUIRE(idx->append(make_view(x)));
+    auto idx2 = roundtrip(idx);
+    auto expected = unbox(idx->lookup(op, make_view(rhs)));
+    CHECK_EQUAL(unbox(idx2->lookup(op, make_view(rhs))), expected);
+    auto nils = unbox(idx->lookup(equal, make_data_view(caf::none)));
+    CHECK_EQUAL(unbox(idx2->lookup(equal, make_data_view(caf::none))), nils);
+  };
+  auto addr = [](auto str) { return data{unbox(to<address>(str))}; };
+  auto sn = [](auto str) { return data{unbox(to<subnet>(str))}; };
+  check(bool_type{}, {true, false, caf::none, true}, equal, true);
+  check(integer_type{}, {integer{-7}, integer{42}, caf::none, integer{3}},
+        less, integer{4});
+  check(count_type{}, {count{7}, count{42}, count{1}}, greater_equal, count{7});
+  check(real_type{}, {4.2, -1.0, caf::none}, greater, 0.0);
+  check(string_type{}, {"foo", "bar", caf::none, "foobar"}, ni, "oo");
+  check(string_type{}.attributes({{"index", "dictionary"}}),
+        {"foo", "bar", caf::none, "foo"}, equal, "foo");
+  check(string_type{}.attributes({{"index", "hash"}}),
+        {"foo", "bar", caf::none, "foo"}, equal, "foo");
+  check(address_type{},
+        {addr("10.0.0.1"), addr("192.168.0.1"), caf::none, addr("::1")}, in,
+        sn("10.0.0.0/8"));
+  check(subnet_type{}, {sn("10.0.0.0/8"), sn("10.1.0.0/16"), caf::none},
+        in, sn("10.0.0.0/8"));
+  check(port_type{}, {port{80, port::tcp}, port{53, port::udp}, caf::none},
+        equal, port{53, port::udp});
+  check(list_type{count_type{}},
+        {list{count{1}, count{2}}, list{count{3}}, caf::none}, ni, count{3});
+}
+
+TEST(flatbuffers - large list of strings) {
+  // A string index has one table per bitmap of every character position, so
+  // this index exceeds the one million tables that a default flatbuffers
+  // verifier allows.
+  auto t = list_type{string_type{}};
+  auto idx = factory<value_index>::make(t, caf::settings{});
+  REQUIRE_NOT_EQUAL(idx, nullptr);
+  list xs;
+  for (auto i = 0; i < 128; ++i)
+    xs.emplace_back(std::string(defaults::index::max_string_size,
+                                static_cast<char>('a' + i % 26)));
+  REQUIRE(idx->append(make_view(data{xs})));
+  REQUIRE(idx->append(make_view(data{list{"foo"}})));
+  auto chk = unbox(fbs::wrap(idx, fbs::file_identifier));
+  value_index_ptr idx2;
+  REQUIRE_EQUAL(fbs::unwrap<fbs::ValueIndex>(as_bytes(chk), idx2), caf::none);
+  REQUIRE_NOT_EQUAL(idx2, nullptr);
+  auto x = "foo"s;
+  CHECK_EQUAL(to_string(unbox(idx2->lookup(ni, make_data_view(x)))), "01");
+  auto& y = caf::get<std::string>(xs[1]);
+  CHECK_EQUAL(to_string(unbox(idx2->lookup(ni, make_data_view(y)))), "10");
+}
+
 // This test uncovered a regression that ocurred when computing the rank of a
 // bitmap representing conn.log events. The culprit was the EWAH bitmap
 // encoding, because swapping out ewah_bitmap for null_bitmap in address_index
@@ -69,6 +69,9 @@ public:
 
   void append_column_to_index(size_type col, value_index& idx) const override;
 
+  void evaluate_column(size_type col, relational_operator op, const data& rhs,
+                       ids& result) const override;
+
   caf::atom_value implementation_id() const noexcept override;
 
   vast::data_view at(size_type row, size_type col) const override;
@@ -95,6 +95,9 @@ public:
 protected:
   bool add_impl(vast::data_view x) override;
 
+  /// Appends the columns directly to the Arrow builders.
+  bool add_columns_impl(const std::vector<column>& xs, size_t rows) override;
+
 private:
   // -- member variables -------------------------------------------------------
 
@@ -0,0 +1,72 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/data.hpp"
+#include "vast/fwd.hpp"
+#include "vast/ids.hpp"
+#include "vast/operator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vast {
+
+/// A candidate check compiled for a single layout. Compilation resolves all
+/// extractors of a tailored expression to column offsets or constants and
+/// flattens the expression tree into a prefix program, so that checking a
+/// table slice neither walks the expression tree nor inspects the layout.
+class candidate_checker {
+public:
+  /// Compiles an expression for a layout.
+  /// @param expr The expression, tailored to *layout*.
+  /// @param layout The layout of all slices to check.
+  candidate_checker(const expression& expr, const record_type& layout);
+
+  /// Evaluates the compiled expression over a table slice.
+  /// @param slice The table slice with the layout of the checker.
+  /// @returns The set of row IDs in *slice* for which the expression yields
+  ///          true.
+  ids operator()(const table_slice& slice) const;
+
+private:
+  struct instruction {
+    enum class opcode : uint8_t {
+      constant,    ///< Yields `value` for every row.
+      column,      ///< Yields `column op rhs` for every row.
+      conjunction, ///< Yields the AND of the operands in its subtree.
+      disjunction, ///< Yields the OR of the operands in its subtree.
+      negation,    ///< Yields the NOT of the following operand.
+    };
+
+    opcode code;
+    relational_operator op = equal;
+    bool value = false;
+    size_t column = 0;
+
+    /// The number of instructions of this subtree, including this one.
+    size_t size = 1;
+
+    data rhs;
+  };
+
+  struct compiler;
+
+  ids run(const table_slice& slice, size_t& pc) const;
+
+  std::vector<instruction> program_;
+};
+
+} // namespace vast
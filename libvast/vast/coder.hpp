@@ -93,6 +93,14 @@ public:
   using size_type = typename Bitmap::size_type;
   using value_type = bool;
 
+  singleton_coder() = default;
+
+  /// Constructs a singleton coder from an existing bitmap.
+  /// @param bm The bitmap of the coder.
+  explicit singleton_coder(Bitmap bm) : bitmap_{std::move(bm)} {
+    // nop
+  }
+
   size_t bitmap_count() const noexcept {
     return 1;
   }
@@ -165,6 +173,14 @@ public:
     // nop
   }
 
+  /// Constructs a vector coder from existing bitmaps.
+  /// @param size The number of encoded values.
+  /// @param bitmaps The bitmaps of the coder.
+  vector_coder(size_type size, std::vector<Bitmap> bitmaps)
+    : size_{size}, bitmaps_(std::move(bitmaps)) {
+    // nop
+  }
+
   size_t bitmap_count() const noexcept {
     return bitmaps_.size();
   }
@@ -515,6 +531,19 @@ public:
     init();
   }
 
+  /// Constructs a multi-level coder from a base and existing coders.
+  /// @param b The base of the coder.
+  /// @param coders One coder per component of *b*.
+  multi_level_coder(base b, std::vector<coder_type> coders)
+    : base_{std::move(b)}, xs_(base_.size()), coders_{std::move(coders)} {
+    VAST_ASSERT(coders_.size() == base_.size());
+  }
+
+  /// @returns the base of the coder.
+  const base& get_base() const {
+    return base_;
+  }
+
   void encode(value_type x, size_type n = 1) {
     if (xs_.empty())
       init();
@@ -24,6 +24,7 @@
 #include <caf/settings.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace vast {
 
@@ -70,6 +71,14 @@ public:
   /// @pre `init()` was called previously.
   caf::expected<bitmap> lookup(relational_operator op, data_view rhs);
 
+  /// Queries event IDs for a batch of predicates, sharing work between
+  /// predicates with the same operator.
+  /// @returns One result per predicate in *xs*, such that a failing predicate
+  ///          does not affect the results of the others.
+  /// @pre `init()` was called previously.
+  std::vector<caf::expected<bitmap>>
+  lookup(const std::vector<curried_predicate>& xs);
+
   /// @returns the file name for loading and storing the index.
   const path& filename() const {
     return filename_;
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <cmath>
+#include <iterator>
 #include <limits>
 #include <type_traits>
 
@@ -52,6 +53,15 @@ struct real_parser : parser<real_parser<T, Policies...>> {
 
   template <class Base, class Exp>
   static Base pow10(Exp exp) {
+    // Powers of ten up to 1e22 are exact doubles, for which std::pow yields
+    // the same result. The lookup thus covers the scaling of every fractional
+    // part, e.g., those of timestamps.
+    static constexpr double exact[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+    if (exp >= 0 && exp < static_cast<Exp>(std::size(exact)))
+      return static_cast<Base>(exact[exp]);
     return std::pow(Base{10}, exp);
   }
 
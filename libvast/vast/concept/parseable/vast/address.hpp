@@ -99,11 +99,35 @@ struct address_parser : vast::parser<address_parser> {
     return v6;
   }
 
+  /// Parses a dotted-quad IPv4 address. Accepts exactly the same input as the
+  /// parser from `make_v4`, but without the overhead of the combinators.
+  /// @param bytes Receives the four octets unless `nullptr`.
+  template <class Iterator>
+  static bool parse_v4(Iterator& f, const Iterator& l, uint8_t* bytes) {
+    auto i = f;
+    for (auto octet = 0; octet < 4; ++octet) {
+      if (octet > 0) {
+        if (i == l || *i != '.')
+          return false;
+        ++i;
+      }
+      auto x = 0u;
+      auto digits = 0;
+      for (; i != l && digits < 3 && *i >= '0' && *i <= '9'; ++i, ++digits)
+        x = x * 10 + (*i - '0');
+      if (digits == 0 || x > 255)
+        return false;
+      if (bytes)
+        bytes[octet] = static_cast<uint8_t>(x);
+    }
+    f = i;
+    return true;
+  }
+
   template <class Iterator>
   bool parse(Iterator& f, const Iterator& l, unused_type) const {
-    static auto v4 = make_v4();
     static auto v6 = make_v6();
-    if (v4(f, l, unused))
+    if (parse_v4(f, l, nullptr))
       return true;
     if (v6(f, l, unused))
       return true;
@@ -123,9 +147,8 @@ struct access::parser<address> : vast::parser<access::parser<address>> {
 
   template <class Iterator>
   bool parse(Iterator& f, const Iterator& l, address& a) const {
-    static auto const v4 = address_parser::make_v4();
     auto begin = f;
-    if (v4(f, l, a.bytes_[12], a.bytes_[13], a.bytes_[14], a.bytes_[15])) {
+    if (address_parser::parse_v4(f, l, &a.bytes_[12])) {
       std::copy(address::v4_mapped_prefix.begin(),
                 address::v4_mapped_prefix.end(), a.bytes_.begin());
       return true;
@@ -17,6 +17,8 @@
 #include "vast/concept/parseable/numeric/integral.hpp"
 #include "vast/port.hpp"
 
+#include <string_view>
+
 namespace vast {
 
 struct port_type_parser : parser<port_type_parser> {
@@ -24,36 +26,41 @@ struct port_type_parser : parser<port_type_parser> {
 
   template <class Iterator>
   bool parse(Iterator& f, const Iterator& l, unused_type) const {
-    using namespace parsers;
-    using namespace parser_literals;
-    // clang-format off
-    auto p
-      = ( "?"_p
-        | "icmp6"
-        | "icmp"
-        | "tcp"
-        | "udp"
-        | "sctp"
-        );
-    // clang-format on
-    return p(f, l, unused);
+    port::port_type x;
+    return parse(f, l, x);
   }
 
+  // Equivalent to the choice of the literals "?", "icmp6", "icmp", "tcp",
+  // "udp", and "sctp", but dispatches on the first character.
   template <class Iterator>
   bool parse(Iterator& f, const Iterator& l, port::port_type& x) const {
-    using namespace parsers;
-    using namespace parser_literals;
-    // clang-format off
-    auto p
-      = ( "?"_p ->* [] { return port::unknown; }
-        | "icmp6"_p ->* [] { return port::icmp6; }
-        | "icmp"_p ->* [] { return port::icmp; }
-        | "tcp"_p ->* [] { return port::tcp; }
-        | "udp"_p ->* [] { return port::udp; }
-        | "sctp"_p ->* [] { return port::sctp; }
-        );
-    // clang-format on
-    return p(f, l, x);
+    auto match = [&](std::string_view str, port::port_type type) {
+      auto i = f;
+      for (auto c : str) {
+        if (i == l || *i != c)
+          return false;
+        ++i;
+      }
+      f = i;
+      x = type;
+      return true;
+    };
+    if (f == l)
+      return false;
+    switch (*f) {
+      default:
+        return false;
+      case '?':
+        return match("?", port::unknown);
+      case 'i':
+        return match("icmp6", port::icmp6) || match("icmp", port::icmp);
+      case 't':
+        return match("tcp", port::tcp);
+      case 'u':
+        return match("udp", port::udp);
+      case 's':
+        return match("sctp", port::sctp);
+    }
   }
 };
 
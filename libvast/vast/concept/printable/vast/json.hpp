@@ -19,12 +19,17 @@
 #include "vast/concept/printable/print.hpp"
 #include "vast/concept/printable/std/chrono.hpp"
 #include "vast/concept/printable/string.hpp"
+#include "vast/concept/printable/vast/address.hpp"
 #include "vast/concept/printable/vast/port.hpp"
+#include "vast/concept/printable/vast/subnet.hpp"
 #include "vast/detail/escapers.hpp"
 #include "vast/json.hpp"
 #include "vast/time.hpp"
 #include "vast/view.hpp"
 
+#include <algorithm>
+#include <charconv>
+
 namespace vast {
 
 //struct json_type_printer : printer<json_type_printer> {
@@ -81,7 +86,14 @@ struct json_printer : printer<json_printer<TreePolicy, Indent, Padding>> {
 
     template <class T>
     bool operator()(const T& x) {
-      if constexpr (std::is_arithmetic_v<T>) {
+      if constexpr (std::is_integral_v<T>) {
+        char buf[24];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), x);
+        return ec == std::errc{}
+               && printers::str.print(out_, std::string_view{
+                                              buf, static_cast<size_t>(
+                                                     end - buf)});
+      } else if constexpr (std::is_arithmetic_v<T>) {
         auto str = std::to_string(x);
         json::number i;
         if constexpr (std::is_floating_point_v<T>) {
@@ -104,8 +116,21 @@ struct json_printer : printer<json_printer<TreePolicy, Indent, Padding>> {
     }
 
     bool operator()(const std::string_view& str) {
-      static auto p = '"' << printers::escape(detail::json_escaper) << '"';
-      return p.print(out_, str);
+      // Copy runs of characters that need no escaping at once, and only
+      // fall back to the escaper for the remaining characters.
+      *out_++ = '"';
+      auto f = str.data();
+      auto l = f + str.size();
+      while (f != l) {
+        auto i = detail::find_control_or<'"', '\\'>(f, l);
+        out_ = std::copy(f, i, out_);
+        if (i == l)
+          break;
+        f = i;
+        detail::json_escaper(f, out_);
+      }
+      *out_++ = '"';
+      return true;
     }
 
     bool operator()(const std::string& str) {
@@ -116,6 +141,16 @@ struct json_printer : printer<json_printer<TreePolicy, Indent, Padding>> {
       return (*this)(x.string());
     }
 
+    bool operator()(const view<address>& x) {
+      static auto p = '"' << make_printer<address>{} << '"';
+      return p.print(out_, x);
+    }
+
+    bool operator()(const view<subnet>& x) {
+      static auto p = '"' << make_printer<subnet>{} << '"';
+      return p.print(out_, x);
+    }
+
     bool operator()(const view<port>& x) {
       static auto p = '"' << make_printer<port>{} << '"';
       return p.print(out_, x);
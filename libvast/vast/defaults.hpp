@@ -40,6 +40,11 @@ namespace import {
 /// Maximum size for sources that generate table slices.
 constexpr size_t table_slice_size = 100;
 
+/// Desired time to fill a table slice for sources that adapt the table slice
+/// size to their input, i.e., when `import.min-batch-size` is set.
+constexpr std::chrono::milliseconds batch_latency
+  = std::chrono::milliseconds{500};
+
 #if VAST_HAVE_ARROW
 
 /// The default table slice type when arrow is available.
@@ -59,6 +64,15 @@ constexpr size_t max_events = 0;
 /// batching and table slices being unfinished.
 constexpr std::chrono::milliseconds read_timeout = std::chrono::seconds{10};
 
+/// Number of threads for parsing input in readers that support it. A value of
+/// zero uses one thread per hardware thread.
+constexpr size_t parse_threads = 1;
+
+/// Maximum time that a datagram source buffers received datagrams before
+/// parsing them as one batch.
+constexpr std::chrono::milliseconds datagram_flush_interval
+  = std::chrono::milliseconds{100};
+
 /// Contains settings for the zeek subcommand.
 struct zeek {
   /// Nested category in config files for this subcommand.
@@ -154,6 +168,10 @@ struct pcap {
   /// of 65535 should be sufficient, on most if not all networks, to capture all
   /// the data available from the packet.
   static constexpr size_t snaplen = 65535;
+
+  /// Size of the kernel capture buffer in bytes for live capture. A value of
+  /// zero uses the default of libpcap.
+  static constexpr size_t buffer_size = 0;
 };
 
 } // namespace import
@@ -254,6 +272,10 @@ struct arrow {
   static constexpr const char* category = "export.arrow";
   /// Path for writing query results.
   static constexpr auto write = vast::defaults::export_::shared::write;
+
+  /// Maximum number of rows per record batch when converting table slices of
+  /// other encodings to Arrow.
+  static constexpr size_t batch_size = 65'536;
 };
 
 /// Contains settings for the pcap subcommand.
@@ -296,6 +318,10 @@ constexpr size_t max_string_size = 1024;
 /// or table).
 constexpr size_t max_container_elements = 256;
 
+/// The maximum number of distinct values in a dictionary index before it
+/// falls back to a regular string index.
+constexpr size_t max_dictionary_size = 256;
+
 } // namespace index
 
 // -- constants for the logger -------------------------------------------------
@@ -15,12 +15,43 @@
 
 #include <array>
 #include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "vast/detail/coding.hpp"
 
 namespace vast::detail {
 
+/// Finds the first ASCII control character or one of *Extra* in a string.
+/// Checks eight bytes at a time, such that escaping printers can copy long
+/// runs of characters that need no escaping in one go.
+/// @param first The beginning of the string.
+/// @param last The end of the string.
+/// @returns A pointer to the first matching character or *last*.
+template <char... Extra>
+const char* find_control_or(const char* first, const char* last) {
+  constexpr uint64_t ones = 0x0101010101010101;
+  constexpr uint64_t highs = 0x8080808080808080;
+  auto has_zero = [](uint64_t x) { return (x - ones) & ~x & highs; };
+  auto is_match = [](char c) {
+    auto u = static_cast<unsigned char>(c);
+    return u < 0x20 || u == 0x7f || ((c == Extra) || ...);
+  };
+  for (; last - first >= 8; first += 8) {
+    uint64_t x;
+    std::memcpy(&x, first, sizeof(x));
+    auto hit = ((x - ones * 0x20) & ~x & highs) | has_zero(x ^ (ones * 0x7f))
+               | (has_zero(x ^ (ones * static_cast<unsigned char>(Extra)))
+                  | ... | 0);
+    if (hit != 0)
+      break;
+  }
+  while (first != last && !is_match(*first))
+    ++first;
+  return first;
+}
+
 inline auto hex_escaper = [](auto& f, auto out) {
   auto hex = byte_to_hex(*f++);
   *out++ = '\\';
@@ -0,0 +1,41 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+namespace vast::detail {
+
+/// A hash function for string keys that supports heterogeneous lookup with
+/// `std::string_view`, e.g., in a `tsl::robin_map<std::string, T>`.
+struct heterogeneous_string_hash {
+  using is_transparent = void; // Opt-in to heterogenous lookups.
+
+  size_t operator()(std::string_view x) const noexcept {
+    return std::hash<std::string_view>{}(x);
+  }
+};
+
+/// The key equality counterpart to ::heterogeneous_string_hash.
+struct heterogeneous_string_equal {
+  using is_transparent = void; // Opt-in to heterogenous lookups.
+
+  bool operator()(std::string_view x, std::string_view y) const noexcept {
+    return x == y;
+  }
+};
+
+} // namespace vast::detail
@@ -19,16 +19,25 @@
 #include <cstdint>
 #include <istream>
 #include <string>
+#include <string_view>
 
 namespace vast::detail {
 
-// A range of non-empty lines, extracted via `std::getline`.
+// A range of non-empty lines, extracted via `std::getline`. If the input uses
+// a detail::mmapbuf as its streambuf, the range instead splits the mapped
+// memory region directly and yields views into the mapping without copying.
 class line_range : range_facade<line_range> {
 public:
   explicit line_range(std::istream& input);
 
+  // Copies the current line into an internal buffer for memory-mapped input.
+  // Prefer `view()` where a std::string_view suffices.
   const std::string& get() const;
 
+  // Returns the current line, which remains valid until the next call to
+  // `next()` or `next_timeout()`.
+  std::string_view view() const;
+
   void next();
 
   // This is only supported if input_ uses a detail::fdinbuf as its streambuf,
@@ -49,9 +58,17 @@ public:
   size_t line_number() const;
 
 private:
+  void next_mapped();
+
   std::istream& input_;
-  std::string line_;
+  mutable std::string line_;
   size_t line_number_ = 0;
+  std::string_view current_;
+
+  // The unconsumed part of the mapped memory region, if the input is mapped.
+  const char* mapped_ = nullptr;
+  const char* mapped_end_ = nullptr;
+  mutable bool materialized_ = true;
 };
 
 } // namespace vast::detail
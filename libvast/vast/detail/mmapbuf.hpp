@@ -17,6 +17,7 @@
 #include "vast/path.hpp"
 
 #include <cstddef>
+#include <memory>
 #include <streambuf>
 #include <string>
 
@@ -42,6 +43,14 @@ public:
   explicit mmapbuf(const path& filename, size_t size = 0,
                    size_t offset = 0);
 
+  /// Constructs a read-only memory-mapped stream buffer of an existing file
+  /// and advises the kernel that the mapping will be read sequentially.
+  /// The returned buffer supports only the get area.
+  /// @param filename The path to the file to map.
+  /// @returns A buffer that maps the entire file, or `nullptr` if the file
+  ///          cannot be mapped, e.g., because it is empty.
+  static std::unique_ptr<mmapbuf> map_readonly(const path& filename);
+
   /// Closes the opened file and unmaps the mapped memory region.
   ~mmapbuf();
 
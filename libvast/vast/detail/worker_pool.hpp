@@ -0,0 +1,67 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vast::detail {
+
+/// A fixed set of long-lived threads that run batches of tasks. Reusing the
+/// threads across batches avoids creating and joining threads for every batch.
+class worker_pool {
+public:
+  /// Constructs a pool.
+  /// @param size The number of threads that run tasks, including the thread
+  ///             that calls `run`.
+  explicit worker_pool(size_t size);
+
+  worker_pool(const worker_pool&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+
+  ~worker_pool();
+
+  /// @returns the number of threads that run tasks, including the caller.
+  size_t size() const noexcept;
+
+  /// Invokes `f(i)` for every `i` in *[0, n)*. The calling thread takes part
+  /// in running the tasks and returns after all of them finished.
+  /// @pre `f` must not throw.
+  void run(size_t n, std::function<void(size_t)> f);
+
+private:
+  /// Runs tasks of the current batch until none are left.
+  void drain();
+
+  /// The loop of a worker thread.
+  void work();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable work_done_;
+  std::function<void(size_t)> task_;
+  size_t num_tasks_ = 0;
+  std::atomic<size_t> next_task_{0};
+  size_t batch_ = 0;
+  size_t busy_workers_ = 0;
+  bool stop_ = false;
+};
+
+} // namespace vast::detail
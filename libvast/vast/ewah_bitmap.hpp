@@ -96,6 +96,12 @@ public:
 
   explicit ewah_bitmap(size_type n, bool bit = false);
 
+  /// Constructs an EWAH bitmap from its raw representation.
+  /// @param blocks The EWAH-encoded blocks.
+  /// @param last_marker The index of the last marker block.
+  /// @param num_bits The number of bits in the bitmap.
+  ewah_bitmap(block_vector blocks, size_type last_marker, size_type num_bits);
+
   // -- inspectors -----------------------------------------------------------
 
   bool empty() const;
@@ -104,6 +110,8 @@ public:
 
   const block_vector& blocks() const;
 
+  size_type last_marker() const;
+
   // -- modifiers ------------------------------------------------------------
 
   void append_bit(bool bit);
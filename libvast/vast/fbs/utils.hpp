@@ -45,7 +45,8 @@ constexpr const char* file_identifier = "VAST";
 /// @returns The buffer of *builder*.
 chunk_ptr release(flatbuffers::FlatBufferBuilder& builder);
 
-/// Creates a verifier for a byte buffer.
+/// Creates a verifier for a byte buffer. The maximum number of tables grows
+/// with the size of the buffer, such that large value indexes pass.
 /// @xs The buffer to create a verifier for.
 /// @param A verifier that is ready to use.
 flatbuffers::Verifier make_verifier(span<const byte> xs);
@@ -98,11 +99,10 @@ template <class Flatbuffer, size_t Extent = dynamic_extent>
 const Flatbuffer* as_flatbuffer(span<const byte, Extent> xs) {
   // Verify the buffer.
   auto data = reinterpret_cast<const uint8_t*>(xs.data());
-  auto size = xs.size();
   char const* identifier = nullptr;
   if (flatbuffers::BufferHasIdentifier(data, file_identifier))
     identifier = file_identifier;
-  flatbuffers::Verifier verifier{data, size};
+  auto verifier = make_verifier(xs);
   if (!verifier.template VerifyBuffer<Flatbuffer>(identifier))
     return nullptr;
   return flatbuffers::GetRoot<Flatbuffer>(data);
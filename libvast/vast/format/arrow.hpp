@@ -24,12 +24,17 @@
 #include <arrow/io/api.h>
 #include <arrow/ipc/writer.h>
 
+#include <iosfwd>
 #include <memory>
 #include <vector>
 
 namespace vast::format::arrow {
 
-/// An Arrow writer.
+/// An Arrow writer. Table slices that are already Arrow-encoded go to the
+/// output as-is, without copying their record batches. Consecutive table
+/// slices of other encodings with the same layout get converted into a
+/// shared record batch that the writer emits when reaching the configured
+/// batch size, on layout change, or on flush.
 class writer : public format::writer {
 public:
   using defaults = vast::defaults::export_::arrow;
@@ -39,12 +44,20 @@ public:
   using batch_writer_ptr = std::shared_ptr<::arrow::ipc::RecordBatchWriter>;
 
   writer();
+
+  /// Constructs an Arrow writer that writes to a C++ output stream, e.g., a
+  /// file or a UNIX domain socket.
+  /// @param out The output stream.
+  explicit writer(std::unique_ptr<std::ostream> out);
+
   writer(writer&&) = default;
   writer& operator=(writer&&) = default;
   ~writer() override;
 
   caf::error write(const table_slice& x) override;
 
+  caf::expected<void> flush() override;
+
   const char* name() const override;
 
   void out(output_stream_ptr ptr) {
@@ -56,6 +69,9 @@ public:
 private:
   caf::error write_arrow_batches(const arrow_table_slice& x);
 
+  /// Writes the rows of the current builder as a single record batch.
+  caf::error finish_batch();
+
   output_stream_ptr out_;
   record_type current_layout_;
   table_slice_builder_ptr current_builder_;
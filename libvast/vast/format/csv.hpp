@@ -24,10 +24,14 @@
 #include "vast/format/ostream_writer.hpp"
 #include "vast/format/single_layout_reader.hpp"
 #include "vast/schema.hpp"
+#include "vast/view.hpp"
 
 #include <caf/fwd.hpp>
 #include <caf/none.hpp>
 
+#include <string_view>
+#include <vector>
+
 namespace vast::format::csv {
 
 struct options {
@@ -60,6 +64,9 @@ public:
   using iterator_type = std::string::const_iterator;
   using parser_type = type_erased_parser<iterator_type>;
 
+  /// Parses a single unquoted field into a value of a fixed type.
+  using field_parser = bool (*)(std::string_view, data_view&);
+
   /// Constructs a CSV reader.
   /// @param table_slice_type The ID for table slice type to build.
   /// @param options Additional options.
@@ -91,11 +98,18 @@ private:
 
   caf::expected<parser_type> read_header(std::string_view line);
 
+  /// Parses a line with the type-specialized field parsers.
+  bool parse_fields(std::string_view line);
+
   std::unique_ptr<std::istream> input_;
   std::unique_ptr<detail::line_range> lines_;
   vast::schema schema_;
   std::vector<rec_table> records;
   caf::optional<parser_type> parser_;
+  /// One parser per column iff all column types support the fast path.
+  std::vector<field_parser> field_parsers_;
+  std::vector<std::string_view> fields_;
+  std::vector<data_view> row_;
   options opt_;
   mutable size_t num_lines_ = 0;
   mutable size_t num_invalid_lines_ = 0;
@@ -22,7 +22,9 @@
 #include "vast/detail/flat_map.hpp"
 #include "vast/detail/line_range.hpp"
 #include "vast/detail/string.hpp"
+#include "vast/detail/worker_pool.hpp"
 #include "vast/error.hpp"
+#include "vast/format/json/field_index.hpp"
 #include "vast/format/multi_layout_reader.hpp"
 #include "vast/format/ostream_writer.hpp"
 #include "vast/fwd.hpp"
@@ -34,7 +36,13 @@
 #include <caf/fwd.hpp>
 #include <caf/settings.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 namespace vast::format::json {
 
@@ -80,6 +88,23 @@ struct default_selector {
     return caf::none;
   }
 
+  const record_type* operator()(const field_index& xs) const {
+    if (type_cache.empty())
+      return nullptr;
+    if (type_cache.size() == 1)
+      return &type_cache.begin()->second;
+    // Only leaf fields make up the cache entry, just like for JSON objects.
+    std::vector<std::string> cache_entry;
+    for (size_t i = 0; i < xs.size(); ++i)
+      if (!xs[i].is_object())
+        cache_entry.emplace_back(xs[i].name);
+    std::sort(cache_entry.begin(), cache_entry.end());
+    if (auto search_result = type_cache.find(cache_entry);
+        search_result != type_cache.end())
+      return &search_result->second;
+    return nullptr;
+  }
+
   caf::error schema(vast::schema sch) {
     if (sch.empty())
       return make_error(ec::invalid_configuration, "no schema provided or type "
@@ -113,6 +138,10 @@ struct default_selector {
 
 /// A reader for JSON data. It operates with a *selector* to determine the
 /// mapping of JSON object to the appropriate record type in the schema.
+/// Selectors that accept a `field_index` enable a faster path that extracts
+/// the columns of the layout without materializing each object. On this path,
+/// selectors return a pointer to the layout, which must remain valid until the
+/// schema of the selector changes.
 template <class Selector = default_selector>
 class reader final : public multi_layout_reader {
 public:
@@ -143,7 +172,80 @@ protected:
 private:
   using iterator_type = std::string_view::const_iterator;
 
+  /// Whether the selector works on a field index instead of a JSON object.
+  static constexpr bool use_field_index
+    = std::is_invocable_v<Selector&, const field_index&>;
+
+  /// The outcome of parsing a single line.
+  enum class line_status { ok, invalid, unknown_layout };
+
+  /// The state for parsing lines via a field index. Every parsing thread has
+  /// its own worker.
+  struct worker {
+    Selector selector;
+    field_index index;
+    std::unordered_map<const record_type*, column_extractor> extractors;
+  };
+
+  /// A line that awaits parsing by one of the worker threads.
+  struct pending_line {
+    std::string line;
+    size_t line_number = 0;
+    caf::expected<line_status> status = line_status::invalid;
+    const record_type* layout = nullptr;
+    std::vector<data> row;
+  };
+
+  /// @returns the worker at position *i*, creating it if necessary.
+  worker& get_worker(size_t i);
+
+  /// Parses a line into a row via a field index.
+  /// @param w The worker to use.
+  /// @param line The line to parse.
+  /// @param layout The layout of the line on success.
+  /// @param row The values of the line on success.
+  /// @returns The outcome or an error iff a value has the wrong type.
+  static caf::expected<line_status>
+  parse_indexed(worker& w, std::string_view line, const record_type*& layout,
+                std::vector<data>& row);
+
+  /// Counts and reports lines that failed to parse.
+  void skip(line_status status, std::string_view line, size_t line_number);
+
+  /// Adds a parsed row to the builder of its layout.
+  /// @param layout The layout as returned by the selector of a worker.
+  caf::error add_row(const record_type* layout, const std::vector<data>& row,
+                     table_slice_builder_ptr& bptr);
+
+  /// Reads a line via a field index.
+  /// @returns `false` iff the line should be skipped.
+  caf::expected<bool> read_indexed(std::string_view line,
+                                   table_slice_builder_ptr& bptr);
+
+  /// Reads the next chunk of lines and parses it with multiple threads.
+  /// @returns An error iff the input ended or timed out while reading.
+  caf::error read_chunk();
+
+  /// Reads lines in chunks and parses each chunk with multiple threads.
+  caf::error read_parallel(size_t max_events, size_t max_slice_size,
+                           consumer& cons);
+
+  /// Reads a line via a JSON object.
+  /// @returns `false` iff the line should be skipped.
+  caf::expected<bool> read_object(std::string_view line,
+                                  table_slice_builder_ptr& bptr);
+
   Selector selector_;
+  std::vector<worker> workers_;
+  bool stale_workers_ = false;
+  std::unordered_map<const record_type*, table_slice_builder_ptr>
+    layout_builders_;
+  std::vector<data> row_;
+  std::vector<pending_line> chunk_;
+  size_t chunk_size_ = 0;
+  size_t chunk_pos_ = 0;
+  std::unique_ptr<detail::worker_pool> pool_;
+  size_t parse_threads_ = vast::defaults::import::parse_threads;
   std::unique_ptr<std::istream> input_;
   std::unique_ptr<detail::line_range> lines_;
   caf::optional<size_t> proto_field_;
@@ -168,6 +270,13 @@ reader<Selector>::reader(caf::atom_value table_slice_type,
       VAST_WARNING(this, "cannot set import.batch-timeout to",
                    *read_timeout_arg, "as it is not a valid duration");
   }
+  parse_threads_ = caf::get_or(options, "import.parse-threads",
+                               vast::defaults::import::parse_threads);
+  if (parse_threads_ == 0)
+    parse_threads_ = std::max(1u, std::thread::hardware_concurrency());
+  if (parse_threads_ > 1 && !use_field_index)
+    VAST_WARNING(this, "ignores import.parse-threads because its selector "
+                       "does not support parallel parsing");
   if (in != nullptr)
     reset(std::move(in));
 }
@@ -181,6 +290,15 @@ void reader<Selector>::reset(std::unique_ptr<std::istream> in) {
 
 template <class Selector>
 caf::error reader<Selector>::schema(vast::schema s) {
+  // The workers hold copies of the selector, which we need to recreate. The
+  // rows of a pending chunk refer to layouts of the current workers, so we
+  // keep them until the chunk is drained.
+  if (chunk_pos_ == chunk_size_) {
+    workers_.clear();
+    layout_builders_.clear();
+  } else {
+    stale_workers_ = true;
+  }
   return selector_.schema(std::move(s));
 }
 
@@ -220,6 +338,9 @@ caf::error reader<Selector>::read_impl(size_t max_events, size_t max_slice_size,
   VAST_TRACE("json-reader", VAST_ARG(max_events), VAST_ARG(max_slice_size));
   VAST_ASSERT(max_events > 0);
   VAST_ASSERT(max_slice_size > 0);
+  if constexpr (use_field_index)
+    if (parse_threads_ > 1)
+      return read_parallel(max_events, max_slice_size, cons);
   size_t produced = 0;
   table_slice_builder_ptr bptr = nullptr;
   auto next_line = [&, start = std::chrono::steady_clock::now()] {
@@ -245,39 +366,22 @@ caf::error reader<Selector>::read_impl(size_t max_events, size_t max_slice_size,
       VAST_DEBUG(this, "reached input timeout at line", lines_->line_number());
       return finish(cons, ec::timeout);
     }
-    auto& line = lines_->get();
+    auto line = lines_->view();
     ++num_lines_;
     if (line.empty()) {
       // Ignore empty lines.
       VAST_DEBUG(this, "ignores empty line at", lines_->line_number());
       continue;
     }
-    vast::json j;
-    if (!parsers::json(line, j)) {
-      if (num_invalid_lines_ == 0)
-        VAST_WARNING(this, "failed to parse line", lines_->line_number(), ":",
-                     line);
-      ++num_invalid_lines_;
-      continue;
+    auto added = use_field_index ? read_indexed(line, bptr)
+                                 : read_object(line, bptr);
+    if (!added) {
+      added.error().context() += caf::make_message("line",
+                                                   lines_->line_number());
+      return finish(cons, added.error());
     }
-    auto xs = caf::get_if<vast::json::object>(&j);
-    if (!xs)
-      return make_error(ec::type_clash, "not a json object");
-    auto layout = selector_(*xs);
-    if (!layout) {
-      if (num_unknown_layouts_ == 0)
-        VAST_WARNING(this, "failed to find a matching type at line",
-                     lines_->line_number(), ":", line);
-      ++num_unknown_layouts_;
+    if (!*added)
       continue;
-    }
-    bptr = builder(*layout);
-    if (bptr == nullptr)
-      return make_error(ec::parse_error, "unable to get a builder");
-    if (auto err = add(*bptr, *xs, *layout)) {
-      err.context() += caf::make_message("line", lines_->line_number());
-      return finish(cons, err);
-    }
     produced++;
     if (bptr->rows() == max_slice_size)
       if (auto err = finish(cons, bptr))
@@ -286,4 +390,231 @@ caf::error reader<Selector>::read_impl(size_t max_events, size_t max_slice_size,
   return finish(cons);
 }
 
+template <class Selector>
+typename reader<Selector>::worker& reader<Selector>::get_worker(size_t i) {
+  while (workers_.size() <= i)
+    workers_.push_back(worker{selector_, {}, {}});
+  return workers_[i];
+}
+
+template <class Selector>
+caf::expected<typename reader<Selector>::line_status>
+reader<Selector>::parse_indexed(worker& w, std::string_view line,
+                                const record_type*& layout,
+                                std::vector<data>& row) {
+  if constexpr (use_field_index) {
+    if (!w.index.reset(line))
+      return line_status::invalid;
+    layout = w.selector(w.index);
+    if (layout == nullptr)
+      return line_status::unknown_layout;
+    auto i = w.extractors.find(layout);
+    if (i == w.extractors.end())
+      i = w.extractors.emplace(layout, column_extractor{*layout}).first;
+    if (auto err = i->second.extract(w.index, row)) {
+      if (err == ec::parse_error)
+        return line_status::invalid;
+      return err;
+    }
+    return line_status::ok;
+  } else {
+    VAST_IGNORE_UNUSED(w);
+    VAST_IGNORE_UNUSED(line);
+    VAST_IGNORE_UNUSED(layout);
+    VAST_IGNORE_UNUSED(row);
+    return make_error(ec::unimplemented, "selector requires a JSON object");
+  }
+}
+
+template <class Selector>
+void reader<Selector>::skip(line_status status, std::string_view line,
+                            size_t line_number) {
+  if (status == line_status::invalid) {
+    if (num_invalid_lines_ == 0)
+      VAST_WARNING(this, "failed to parse line", line_number, ":", line);
+    ++num_invalid_lines_;
+  } else if (status == line_status::unknown_layout) {
+    if (num_unknown_layouts_ == 0)
+      VAST_WARNING(this, "failed to find a matching type at line",
+                   line_number, ":", line);
+    ++num_unknown_layouts_;
+  }
+}
+
+template <class Selector>
+caf::error reader<Selector>::add_row(const record_type* layout,
+                                     const std::vector<data>& row,
+                                     table_slice_builder_ptr& bptr) {
+  // Looking up the builder by layout pointer avoids hashing the full type for
+  // every row.
+  auto& ptr = layout_builders_[layout];
+  if (ptr == nullptr)
+    ptr = builder(*layout);
+  bptr = ptr;
+  if (bptr == nullptr)
+    return make_error(ec::parse_error, "unable to get a builder");
+  for (size_t c = 0; c < row.size(); ++c)
+    if (!bptr->add(make_data_view(row[c])))
+      return make_error(ec::type_clash, "unexpected type",
+                        layout->fields[c].name, ":", row[c]);
+  return caf::none;
+}
+
+template <class Selector>
+caf::expected<bool>
+reader<Selector>::read_indexed(std::string_view line,
+                               table_slice_builder_ptr& bptr) {
+  const record_type* layout = nullptr;
+  auto status = parse_indexed(get_worker(0), line, layout, row_);
+  if (!status)
+    return status.error();
+  if (*status != line_status::ok) {
+    skip(*status, line, lines_->line_number());
+    return false;
+  }
+  if (auto err = add_row(layout, row_, bptr))
+    return err;
+  return true;
+}
+
+template <class Selector>
+caf::error reader<Selector>::read_chunk() {
+  // Spreading too few lines over threads costs more than it gains.
+  constexpr size_t min_lines_per_thread = 128;
+  // The chunk size depends on the number of threads only, so that all threads
+  // have work even when the downstream demand for events is small.
+  constexpr size_t chunk_lines_per_thread = 1024;
+  // Collect a chunk of lines first. We swap the lines out of the line range to
+  // recycle their memory.
+  auto start = std::chrono::steady_clock::now();
+  auto result = caf::error{};
+  chunk_pos_ = 0;
+  chunk_size_ = 0;
+  if (stale_workers_) {
+    workers_.clear();
+    layout_builders_.clear();
+    stale_workers_ = false;
+  }
+  while (chunk_size_ < chunk_lines_per_thread * parse_threads_) {
+    if (lines_->done()) {
+      result = make_error(ec::end_of_input, "input exhausted");
+      break;
+    }
+    if (chunk_size_ == 0) {
+      lines_->next();
+    } else {
+      auto remaining = start + read_timeout_ - std::chrono::steady_clock::now();
+      if (remaining < std::chrono::steady_clock::duration::zero()
+          || lines_->next_timeout(remaining)) {
+        VAST_DEBUG(this, "reached input timeout at line",
+                   lines_->line_number());
+        result = ec::timeout;
+        break;
+      }
+    }
+    auto& line = lines_->line();
+    if (line.empty())
+      continue;
+    ++num_lines_;
+    if (chunk_.size() == chunk_size_)
+      chunk_.emplace_back();
+    auto& x = chunk_[chunk_size_++];
+    x.line.swap(line);
+    x.line_number = lines_->line_number();
+  }
+  // Parse the chunk with up to `parse_threads_` threads, each of which works
+  // on a contiguous range of lines with its own worker.
+  auto num_threads = std::clamp(chunk_size_ / min_lines_per_thread, size_t{1},
+                                parse_threads_);
+  auto lines_per_thread = (chunk_size_ + num_threads - 1) / num_threads;
+  // Create all workers up front, because adding workers invalidates
+  // references to existing ones.
+  get_worker(num_threads - 1);
+  if (pool_ == nullptr)
+    pool_ = std::make_unique<detail::worker_pool>(parse_threads_);
+  pool_->run(num_threads, [&](size_t i) {
+    auto first = std::min(i * lines_per_thread, chunk_size_);
+    auto last = std::min(first + lines_per_thread, chunk_size_);
+    for (auto j = first; j < last; ++j) {
+      auto& x = chunk_[j];
+      x.status = parse_indexed(workers_[i], x.line, x.layout, x.row);
+    }
+  });
+  return result;
+}
+
+template <class Selector>
+caf::error reader<Selector>::read_parallel(size_t max_events,
+                                           size_t max_slice_size,
+                                           consumer& cons) {
+  // Add the parsed rows in input order. Rows beyond `max_events` remain in
+  // the chunk for the next call.
+  auto result = caf::error{};
+  size_t produced = 0;
+  table_slice_builder_ptr bptr = nullptr;
+  while (produced < max_events && !result) {
+    if (chunk_pos_ == chunk_size_)
+      result = read_chunk();
+    while (chunk_pos_ < chunk_size_ && produced < max_events) {
+      auto& x = chunk_[chunk_pos_++];
+      if (!x.status) {
+        auto err = std::move(x.status.error());
+        err.context() += caf::make_message("line", x.line_number);
+        return finish(cons, std::move(err));
+      }
+      if (*x.status != line_status::ok) {
+        skip(*x.status, x.line, x.line_number);
+        continue;
+      }
+      if (auto err = add_row(x.layout, x.row, bptr)) {
+        err.context() += caf::make_message("line", x.line_number);
+        return finish(cons, std::move(err));
+      }
+      ++produced;
+      if (bptr->rows() == max_slice_size)
+        if (auto err = finish(cons, bptr))
+          return err;
+    }
+  }
+  // Report the end of the input only after handing out the remaining rows of
+  // the chunk; the next call runs into it again.
+  if (chunk_pos_ < chunk_size_)
+    return finish(cons);
+  // See read_impl for why we only report a timeout after producing events.
+  if (result == ec::timeout && produced == 0)
+    return finish(cons);
+  return finish(cons, std::move(result));
+}
+
+template <class Selector>
+caf::expected<bool>
+reader<Selector>::read_object(std::string_view line,
+                              table_slice_builder_ptr& bptr) {
+  vast::json j;
+  if (!parsers::json(line, j)) {
+    if (num_invalid_lines_ == 0)
+      VAST_WARNING(this, "failed to parse line", lines_->line_number(), ":",
+                   line);
+    ++num_invalid_lines_;
+    return false;
+  }
+  auto xs = caf::get_if<vast::json::object>(&j);
+  if (!xs)
+    return make_error(ec::type_clash, "not a json object");
+  auto layout = selector_(*xs);
+  if (!layout) {
+    if (num_unknown_layouts_ == 0)
+      VAST_WARNING(this, "failed to find a matching type at line",
+                   lines_->line_number(), ":", line);
+    ++num_unknown_layouts_;
+    return false;
+  }
+  bptr = builder(*layout);
+  if (bptr == nullptr)
+    return make_error(ec::parse_error, "unable to get a builder");
+  if (auto err = add(*bptr, *xs, *layout))
+    return err;
+  return true;
+}
+
 } // namespace vast::format::json
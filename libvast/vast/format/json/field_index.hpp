@@ -0,0 +1,124 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/data.hpp"
+#include "vast/detail/heterogeneous_string_hash.hpp"
+#include "vast/fwd.hpp"
+#include "vast/type.hpp"
+
+#include <caf/error.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <tsl/robin_map.h>
+
+namespace vast::format::json {
+
+/// A flat index over the fields of a single JSON object, built with one pass
+/// over the input and without materializing a DOM. Nested objects contribute
+/// both themselves and their fields under dot-separated names, e.g.,
+/// `{"a": {"b": 1}}` yields the fields `a` and `a.b`. Values remain unparsed
+/// views into the input.
+class field_index {
+public:
+  /// A field of the indexed object.
+  struct field {
+    /// The dot-separated name of the field.
+    std::string name;
+
+    /// The unparsed JSON value of the field.
+    std::string_view value;
+
+    /// Whether the value is a JSON object.
+    bool is_object() const {
+      return !value.empty() && value.front() == '{';
+    }
+  };
+
+  /// Indexes a JSON object. The index references *str*, which must outlive
+  /// all subsequent accesses to the index.
+  /// @param str The JSON object.
+  /// @returns `false` if *str* is not a valid JSON object.
+  bool reset(std::string_view str);
+
+  /// Retrieves the unparsed value of a field.
+  /// @param name The dot-separated name of the field.
+  /// @returns The unparsed value or an empty view if the field does not exist.
+  std::string_view find(std::string_view name) const;
+
+  /// @returns the number of indexed fields.
+  size_t size() const {
+    return size_;
+  }
+
+  /// @returns the field at position *i* in input order.
+  const field& operator[](size_t i) const {
+    return fields_[i];
+  }
+
+private:
+  using iterator = std::string_view::const_iterator;
+
+  bool scan_object(iterator& f, iterator l, size_t prefix_size);
+
+  bool scan_value(iterator& f, iterator l);
+
+  field& emplace_field(std::string_view key, size_t prefix_size);
+
+  // The fields are never erased to reuse the memory of their names between
+  // objects; only the first `size_` fields are valid.
+  std::vector<field> fields_;
+  size_t size_ = 0;
+  std::string path_;
+};
+
+/// Extracts the columns of a layout from indexed JSON objects. Consecutive
+/// objects usually share the same order of fields, so the extractor remembers
+/// the column for every position of the previous object and only looks up a
+/// field by name when the order changes.
+class column_extractor {
+public:
+  /// Constructs an extractor for a flattened layout.
+  explicit column_extractor(record_type layout);
+
+  /// Converts the fields of an indexed object into the values of a row.
+  /// Missing fields and JSON null result in `nil`.
+  /// @param xs The indexed JSON object.
+  /// @param row The values of the row in layout order.
+  /// @returns An error iff a field could not be converted to its column type,
+  ///          or `ec::parse_error` iff the value of a field is malformed.
+  caf::error extract(const field_index& xs, std::vector<data>& row);
+
+  /// @returns the layout of the extractor.
+  const record_type& layout() const {
+    return layout_;
+  }
+
+private:
+  /// The column for a field position of the previous object.
+  size_t column(const field_index& xs, size_t i);
+
+  record_type layout_;
+  tsl::robin_map<std::string, size_t, detail::heterogeneous_string_hash,
+                 detail::heterogeneous_string_equal>
+    columns_;
+  std::vector<size_t> hints_;
+  std::vector<std::string_view> values_;
+};
+
+} // namespace vast::format::json
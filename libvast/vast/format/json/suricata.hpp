@@ -13,8 +13,10 @@
 
 #pragma once
 
+#include "vast/concept/parseable/string/quoted_string.hpp"
 #include "vast/concept/printable/vast/json.hpp"
 #include "vast/detail/string.hpp"
+#include "vast/format/json/field_index.hpp"
 #include "vast/json.hpp"
 #include "vast/logger.hpp"
 #include "vast/schema.hpp"
@@ -46,6 +48,23 @@ struct suricata {
     return type;
   }
 
+  const vast::record_type* operator()(const field_index& xs) {
+    auto value = xs.find("event_type");
+    if (value.empty())
+      return nullptr;
+    event_type_.clear();
+    if (!parsers::qqstr(value, event_type_)) {
+      VAST_WARNING(this, "got an event_type field with a non-string value");
+      return nullptr;
+    }
+    auto it = types.find(event_type_);
+    if (it == types.end()) {
+      VAST_VERBOSE(this, "does not have a layout for event_type", event_type_);
+      return nullptr;
+    }
+    return &it->second;
+  }
+
   caf::error schema(const vast::schema& s) {
     for (auto& t : s) {
       auto sn = detail::split(t.name(), ".");
@@ -74,6 +93,9 @@ struct suricata {
   }
 
   std::unordered_map<std::string, record_type> types;
+
+private:
+  std::string event_type_;
 };
 
 } // namespace vast::format::json
@@ -115,14 +115,21 @@ protected:
       }
       append(end_of_line);
       append('\n');
-      write_buf();
+      if (buf_.size() >= max_buffer_size)
+        write_buf();
     }
+    write_buf();
     return caf::none;
   }
 
   /// Writes the content of `buf_` to `out_` and clears `buf_` afterwards.
   void write_buf();
 
+  /// The buffer size at which writers pass the content of `buf_` to `out_`
+  /// while printing a table slice. Writing whole slices or large chunks
+  /// instead of single lines reduces the number of system calls.
+  static constexpr size_t max_buffer_size = 1 << 20;
+
   /// Buffer for building lines before writing to `out_`. Printing into this
   /// buffer with a `back_inserter` and then calling `out_->write(...)` gives a
   /// 4x speedup over printing directly to `out_`, even when setting
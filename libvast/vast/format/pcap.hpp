@@ -18,6 +18,7 @@
 #include "vast/concept/hashable/xxhash.hpp"
 #include "vast/defaults.hpp"
 #include "vast/detail/operators.hpp"
+#include "vast/detail/worker_pool.hpp"
 #include "vast/flow.hpp"
 #include "vast/format/reader.hpp"
 #include "vast/format/single_layout_reader.hpp"
@@ -31,9 +32,13 @@
 #include <caf/optional.hpp>
 
 #include <chrono>
+#include <memory>
 #include <pcap.h>
 #include <random>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace vast {
 namespace format {
@@ -74,33 +79,97 @@ private:
     std::string community_id;
   };
 
-  /// @returns either an existing state associated to `x` or a new state for
-  ///          the flow.
-  flow_state& state(const flow& x);
+  /// Tracks the state of flows to enforce the cutoff. When parsing with
+  /// multiple threads, every thread owns a table for a disjoint set of flows.
+  class flow_table {
+  public:
+    flow_table(uint64_t cutoff, size_t max_flows, uint64_t max_age,
+               uint64_t expire_interval);
+
+    /// Accounts a packet to its flow and expires inactive flows.
+    /// @returns the state of the flow, or `nullptr` if the flow reached the
+    ///          configured cutoff. The state remains valid until the next call
+    ///          to `update`.
+    const flow_state*
+    update(const flow& x, uint64_t packet_time, uint64_t payload_size);
+
+    void clear();
+
+  private:
+    /// @returns either an existing state associated to `x` or a new state for
+    ///          the flow.
+    flow_state& state(const flow& x);
+
+    /// @returns whether `true` if the flow remains active, `false` if the
+    ///          flow reached the configured cutoff.
+    bool update_flow(const flow& x, uint64_t packet_time,
+                     uint64_t payload_size);
+
+    /// Evict all flows that have been inactive for the maximum age.
+    void evict_inactive(uint64_t packet_time);
+
+    /// Evicts random flows when exceeding the maximum configured flow count.
+    void shrink_to_max_size();
+
+    std::unordered_map<flow, flow_state> flows_;
+    uint64_t cutoff_;
+    size_t max_flows_;
+    std::mt19937 generator_;
+    uint64_t max_age_;
+    uint64_t expire_interval_;
+    uint64_t last_expire_ = 0;
+  };
+
+  /// A decoded packet.
+  struct packet {
+    flow conn;
+    time ts;
+    uint64_t packet_time;
+    uint64_t payload_size;
+    std::string_view layer3;
+
+    // The following members are only used when parsing with multiple
+    // threads, which requires copying packets out of the libpcap buffer.
+    // `layer3` then refers to `buffer` only while adding the packet, since
+    // `buffer` may move while the chunk grows.
+    std::string buffer;
+    size_t shard;
+    bool keep;
+    std::string community_id;
+  };
+
+  /// Opens and activates the capture on `interface_`.
+  caf::error open_live();
 
-  /// @returns whether `true` if the flow remains active, `false` if the flow
-  ///          reached the configured cutoff.
-  bool update_flow(const flow& x, uint64_t packet_time, uint64_t payload_size);
+  /// Decodes a packet up to the transport layer.
+  /// @returns `false` if the packet is not an IP packet.
+  caf::expected<bool>
+  decode(const pcap_pkthdr& header, const u_char* data, packet& result);
 
-  /// Evict all flows that have been inactive for the maximum age.
-  void evict_inactive(uint64_t packet_time);
+  /// Adds a decoded packet to the builder.
+  caf::error add(const packet& x, std::string_view community_id);
 
-  /// Evicts random flows when exceeding the maximum configured flow count.
-  void shrink_to_max_size();
+  /// Reads packets in chunks and tracks their flows with multiple threads.
+  caf::error read_parallel(size_t max_events, size_t max_slice_size,
+                           consumer& f);
 
   pcap_t* pcap_ = nullptr;
-  std::unordered_map<flow, flow_state> flows_;
+  std::vector<flow_table> flows_;
+  std::vector<packet> chunk_;
+  std::vector<std::vector<size_t>> shard_packets_;
+  std::unique_ptr<detail::worker_pool> workers_;
+  size_t parse_threads_;
   std::string input_;
   caf::optional<std::string> interface_;
   uint64_t cutoff_;
   size_t max_flows_;
-  std::mt19937 generator_;
   uint64_t max_age_;
   uint64_t expire_interval_;
-  uint64_t last_expire_ = 0;
   time last_timestamp_ = time::min();
   int64_t pseudo_realtime_;
   size_t snaplen_;
+  size_t buffer_size_;
+  caf::optional<uint16_t> fanout_group_;
   bool community_id_;
   type packet_type_;
   double drop_rate_threshold_;
@@ -20,6 +20,7 @@
 #include "vast/concept/parseable/vast/subnet.hpp"
 #include "vast/data.hpp"
 #include "vast/defaults.hpp"
+#include "vast/detail/escapers.hpp"
 #include "vast/detail/line_range.hpp"
 #include "vast/detail/string.hpp"
 #include "vast/format/ostream_writer.hpp"
@@ -36,8 +37,10 @@
 
 #include <chrono>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -124,6 +127,45 @@ struct zeek_parser {
   Attribute& attr_;
 };
 
+/// Parses an escaped Zeek string into a `data` instance. Unlike a parser built
+/// from combinators, this parser reuses the storage of the string that the
+/// attribute holds already, so that parsing consecutive records does not
+/// allocate once the string reached its steady-state capacity.
+struct zeek_string_parser : parser<zeek_string_parser> {
+  using attribute = data;
+
+  template <class Iterator>
+  bool parse(Iterator& f, const Iterator& l, unused_type) const {
+    if (f == l)
+      return false;
+    f = l;
+    return true;
+  }
+
+  template <class Iterator>
+  bool parse(Iterator& f, const Iterator& l, data& x) const {
+    if (f == l)
+      return false;
+    auto str = caf::get_if<std::string>(&x);
+    if (str == nullptr) {
+      x = std::string{};
+      str = &caf::get<std::string>(x);
+    }
+    str->clear();
+    auto out = std::back_inserter(*str);
+    // Like detail::byte_unescape, we yield an empty string for invalid
+    // escape sequences.
+    while (f != l) {
+      if (!detail::byte_unescaper(f, l, out)) {
+        str->clear();
+        break;
+      }
+    }
+    f = l;
+    return true;
+  }
+};
+
 /// Constructs a polymorphic Zeek data parser.
 template <class Iterator, class Attribute>
 struct zeek_parser_factory {
@@ -168,6 +210,9 @@ struct zeek_parser_factory {
   }
 
   result_type operator()(const string_type&) const {
+    if constexpr (std::is_same_v<Attribute, data>)
+      if (set_separator_.empty())
+        return zeek_string_parser{};
     if (set_separator_.empty())
       return +parsers::any
         ->* [](std::string x) { return detail::byte_unescape(x); };
@@ -265,6 +310,11 @@ private:
   caf::optional<size_t> proto_field_;
   std::vector<size_t> port_fields_;
   std::vector<rule<iterator_type, data>> parsers_;
+
+  // Buffers for parsing a single line, kept across lines such that parsing a
+  // record does not allocate once they reached their steady-state capacity.
+  std::vector<std::string_view> fields_;
+  std::vector<data> values_;
 };
 
 /// A Zeek writer.
@@ -319,6 +319,9 @@ CAF_BEGIN_TYPE_ID_BLOCK(vast, caf::first_custom_type_id)
   VAST_ADD_TYPE_ID((vast::system::type_set))
 
   VAST_ADD_TYPE_ID((std::vector<uint32_t>) )
+  VAST_ADD_TYPE_ID((std::vector<caf::error>) )
+  VAST_ADD_TYPE_ID((std::vector<vast::bitmap>) )
+  VAST_ADD_TYPE_ID((std::vector<vast::curried_predicate>) )
   VAST_ADD_TYPE_ID((std::vector<vast::table_slice_ptr>) )
 
   VAST_ADD_TYPE_ID((caf::stream<vast::table_slice_ptr>) )
@@ -31,8 +31,11 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <limits>
+#include <numeric>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -102,7 +105,11 @@ public:
 
   caf::error deserialize(caf::deserializer& source) override {
     return caf::error::eval([&] { return value_index::deserialize(source); },
-                            [&] { return source(digests_, seeds_); });
+                            [&] { return source(digests_, seeds_); },
+                            [&]() -> caf::error {
+                              seal();
+                              return caf::none;
+                            });
   }
 
 private:
@@ -166,6 +173,66 @@ private:
     return caf::none;
   }
 
+  /// Orders the digests of an immutable index, such that lookups can use a
+  /// binary search instead of a full scan.
+  void seal() {
+    order_.clear();
+    if (digests_.size() > std::numeric_limits<uint32_t>::max())
+      return;
+    order_.resize(digests_.size());
+    std::iota(order_.begin(), order_.end(), uint32_t{0});
+    std::sort(order_.begin(), order_.end(), [&](uint32_t x, uint32_t y) {
+      return less(digests_[x], digests_[y]);
+    });
+  }
+
+  bool sealed() const {
+    return !order_.empty();
+  }
+
+  static bool less(const digest_type& x, const digest_type& y) {
+    return std::memcmp(x.data(), y.data(), Bytes) < 0;
+  }
+
+  /// Computes the IDs of all digests that match one of the given keys in a
+  /// sealed index.
+  /// @param keys The keys to look for.
+  /// @param negate Whether to compute the complement of the result.
+  ids probe(const std::vector<key>& keys, bool negate) const {
+    VAST_ASSERT(sealed());
+    auto lower = [&](uint32_t x, const key& k) {
+      return less(digests_[x], k.bytes);
+    };
+    auto upper = [&](const key& k, uint32_t x) {
+      return less(k.bytes, digests_[x]);
+    };
+    std::vector<uint32_t> positions;
+    for (auto& k : keys) {
+      auto first = std::lower_bound(order_.begin(), order_.end(), k, lower);
+      auto last = std::upper_bound(first, order_.end(), k, upper);
+      positions.insert(positions.end(), first, last);
+    }
+    std::sort(positions.begin(), positions.end());
+    positions.erase(std::unique(positions.begin(), positions.end()),
+                    positions.end());
+    // Translate the positions of the matching digests into IDs.
+    ewah_bitmap result;
+    auto rng = select(this->mask());
+    for (size_t i = 0, last_match = 0; i < positions.size(); ++i) {
+      auto digests_since_last_match = positions[i] - last_match;
+      if (digests_since_last_match > 0)
+        rng.next(digests_since_last_match);
+      last_match = positions[i];
+      result.append_bits(false, rng.get() - result.size());
+      result.append_bit(true);
+    }
+    if (negate) {
+      result.append_bits(false, this->offset() - result.size());
+      result.flip();
+    }
+    return result;
+  }
+
   /// Locates the digest for a given input.
   key find_digest(data_view x) const {
     auto i = seeds_.find(x);
@@ -207,6 +274,8 @@ private:
     };
     if (op == equal || op == not_equal) {
       auto k = find_digest(x);
+      if (sealed())
+        return probe({k}, op == not_equal);
       auto eq = [=](const digest_type& digest) { return k == digest; };
       auto ne = [=](const digest_type& digest) { return k != digest; };
       return op == equal ? scan(eq) : scan(ne);
@@ -230,20 +299,106 @@ private:
         x);
       if (!keys)
         return keys.error();
+      if (sealed())
+        return probe(*keys, op == not_in);
       // We're good to go with: create the set predicates an run the scan.
+      // A hash set keeps the cost per digest constant for large lists.
+      auto key_set = std::unordered_set<key, key_hasher>(keys->begin(),
+                                                         keys->end());
       auto in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) { return k == digest; };
-        return std::any_of(keys->begin(), keys->end(), cmp);
+        return key_set.count(key{digest}) > 0;
       };
       auto not_in_pred = [&](const digest_type& digest) {
-        auto cmp = [=](auto& k) { return k == digest; };
-        return std::none_of(keys->begin(), keys->end(), cmp);
+        return key_set.count(key{digest}) == 0;
       };
       return op == in ? scan(in_pred) : scan(not_in_pred);
     }
     return make_error(ec::unsupported_operator, op);
   }
 
+  caf::expected<std::vector<ids>>
+  lookup_batch_impl(relational_operator op,
+                    const std::vector<data_view>& xs) const override {
+    if (!(op == equal || op == not_equal))
+      return value_index::lookup_batch_impl(op, xs);
+    VAST_ASSERT(rank(this->mask()) == digests_.size());
+    if (sealed()) {
+      std::vector<ids> result;
+      result.reserve(xs.size());
+      for (auto& x : xs)
+        result.push_back(probe({find_digest(x)}, op == not_equal));
+      return result;
+    }
+    // Map every digest to the positions of the values that hash to it, such
+    // that a single pass over all digests answers the entire batch.
+    std::unordered_map<key, std::vector<size_t>, key_hasher> positions;
+    for (size_t i = 0; i < xs.size(); ++i)
+      positions[find_digest(xs[i])].push_back(i);
+    std::vector<ewah_bitmap> hits(xs.size());
+    auto rng = select(this->mask());
+    if (!rng.done()) {
+      for (size_t i = 0, last_match = 0; i < digests_.size(); ++i) {
+        auto it = positions.find(key{digests_[i]});
+        if (it == positions.end())
+          continue;
+        auto digests_since_last_match = i - last_match;
+        if (digests_since_last_match > 0)
+          rng.next(digests_since_last_match);
+        last_match = i;
+        auto id = rng.get();
+        for (auto j : it->second) {
+          hits[j].append_bits(false, id - hits[j].size());
+          hits[j].append_bit(true);
+        }
+      }
+    }
+    std::vector<ids> result;
+    result.reserve(hits.size());
+    for (auto& x : hits) {
+      if (op == not_equal) {
+        x.append_bits(false, this->offset() - x.size());
+        x.flip();
+      }
+      result.emplace_back(std::move(x));
+    }
+    return result;
+  }
+
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override {
+    // Prune unneeded seeds.
+    decltype(seeds_) non_null_seeds;
+    for (auto& [k, v] : seeds_)
+      if (v > 0)
+        non_null_seeds.emplace(k, v);
+    auto seeds = detail::pack_caf_binary(builder, non_null_seeds);
+    if (!seeds)
+      return seeds.error();
+    auto ptr = reinterpret_cast<const uint8_t*>(digests_.data());
+    auto digests = builder.CreateVector(ptr, digests_.size() * Bytes);
+    auto state = fbs::CreateHashIndex(builder, Bytes, digests, *seeds);
+    return packed_state{fbs::ValueIndexState::hash, state.Union()};
+  }
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override {
+    auto state = x.state_as_hash();
+    if (!state || !state->digests())
+      return make_error(ec::format_error, "expected hash index state");
+    if (state->digest_size() != Bytes)
+      return make_error(ec::format_error, "digest size mismatch",
+                        state->digest_size(), Bytes);
+    auto digests = state->digests();
+    if (digests->size() % Bytes != 0)
+      return make_error(ec::format_error, "truncated digests");
+    digests_.resize(digests->size() / Bytes);
+    std::memcpy(digests_.data(), digests->data(), digests->size());
+    unique_digests_.clear();
+    if (auto err = detail::unpack_caf_binary(state->seeds(), seeds_))
+      return err;
+    seal();
+    return caf::none;
+  }
+
   bool immutable() const {
     return unique_digests_.empty() && !digests_.empty();
   }
@@ -251,6 +406,10 @@ private:
   std::vector<digest_type> digests_;
   std::unordered_set<key, key_hasher> unique_digests_;
 
+  /// The positions of `digests_` in ascending digest order. Only exists after
+  /// loading an index from disk, at which point the index is immutable.
+  std::vector<uint32_t> order_;
+
   struct data_hash {
     size_t operator()(const data& x) const {
       // The default hash computation for `data` and `data_view` is subtly
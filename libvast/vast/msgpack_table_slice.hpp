@@ -18,6 +18,7 @@
 #include <caf/fwd.hpp>
 #include <caf/intrusive_cow_ptr.hpp>
 
+#include <cstdint>
 #include <vector>
 
 #include <vast/byte.hpp>
@@ -79,9 +80,22 @@ public:
 private:
   using table_slice::table_slice;
 
+  /// @returns the data at given row and column, decoded as type *t*.
+  vast::data_view at(size_type row, size_type col, const type& t) const;
+
+  /// Computes the offset of every cell, such that accessing a cell does not
+  /// require skipping all preceding columns of its row. Does nothing if the
+  /// buffer exceeds the range of 32-bit offsets.
+  void index_cells();
+
   /// Offsets from the beginning of the buffer to each row.
   std::vector<size_t> offset_table_;
 
+  /// Offsets from the beginning of the buffer to each cell in row-major
+  /// order. Computed after construction and never serialized; empty if not
+  /// available.
+  std::vector<uint32_t> cell_offsets_;
+
   /// The buffer that contains the MessagePack data.
   vast::span<const vast::byte> buffer_;
 
@@ -72,6 +72,10 @@ public:
 protected:
   bool add_impl(vast::data_view x) override;
 
+  /// Encodes the columns row by row without a per-value type check, because
+  /// the columns have already been checked against the layout.
+  bool add_columns_impl(const std::vector<column>& xs, size_t rows) override;
+
 private:
   // -- member variables -------------------------------------------------------
 
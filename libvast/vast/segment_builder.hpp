@@ -17,12 +17,15 @@
 #include "vast/fbs/segment.hpp"
 #include "vast/fbs/table_slice.hpp"
 #include "vast/segment.hpp"
+#include "vast/type.hpp"
 #include "vast/uuid.hpp"
 
 #include <caf/expected.hpp>
 #include <caf/fwd.hpp>
 
 #include <cstddef>
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 namespace vast {
@@ -71,6 +74,8 @@ private:
   uint64_t num_events_;
   flatbuffers::FlatBufferBuilder builder_;
   std::vector<flatbuffers::Offset<fbs::TableSliceBuffer>> flat_slices_;
+  std::vector<flatbuffers::Offset<fbs::LayoutBuffer>> flat_layouts_;
+  std::unordered_map<record_type, uint32_t> layout_ids_;
   std::vector<table_slice_ptr> slices_; // For queries to an unfinished segment.
   std::vector<fbs::Interval> intervals_;
 };
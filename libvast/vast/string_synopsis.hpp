@@ -0,0 +1,149 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/bloom_filter_parameters.hpp"
+#include "vast/bloom_filter_synopsis.hpp"
+
+#include <caf/config_value.hpp>
+#include <caf/settings.hpp>
+
+#include <vast/detail/assert.hpp>
+#include <vast/logger.hpp>
+
+#include <string>
+
+namespace vast {
+
+/// A synopsis for strings that serve as keys to correlate events across
+/// layouts, e.g., the Zeek `uid` or the `community_id`. Such fields carry the
+/// `#index=hash` attribute. The synopsis allows the META INDEX to skip all
+/// partitions that do not contain any of the looked up keys, which turns
+/// pivoting into a lookup in few partitions.
+template <class HashFunction>
+class string_synopsis final
+  : public bloom_filter_synopsis<std::string, HashFunction> {
+public:
+  using super = bloom_filter_synopsis<std::string, HashFunction>;
+
+  /// Constructs a string synopsis from a `string_type` and a Bloom filter.
+  string_synopsis(type x, typename super::bloom_filter_type bf)
+    : super{std::move(x), std::move(bf)} {
+    VAST_ASSERT(caf::holds_alternative<string_type>(this->type()));
+  }
+
+  caf::optional<bool>
+  lookup(relational_operator op, data_view rhs) const override {
+    // Unlike for addresses, the right-hand side of a string predicate may be
+    // of a different type, e.g., a pattern.
+    auto lookup_string = [&](const data_view& x) -> caf::optional<bool> {
+      if (auto str = caf::get_if<view<std::string>>(&x))
+        return this->bloom_filter_.lookup(*str);
+      return caf::none;
+    };
+    switch (op) {
+      default:
+        return caf::none;
+      case equal:
+        return lookup_string(rhs);
+      case in: {
+        if (auto xs = caf::get_if<view<list>>(&rhs)) {
+          for (auto x : **xs) {
+            auto result = lookup_string(x);
+            if (!result || *result)
+              return result;
+          }
+          return false;
+        }
+        return caf::none;
+      }
+    }
+  }
+
+  bool equals(const synopsis& other) const noexcept override {
+    if (typeid(other) != typeid(string_synopsis))
+      return false;
+    auto& rhs = static_cast<const string_synopsis&>(other);
+    return this->type() == rhs.type()
+           && this->bloom_filter_ == rhs.bloom_filter_;
+  }
+};
+
+/// Factory to construct a string synopsis.
+/// @tparam HashFunction The hash function to use for the Bloom filter.
+/// @param type A type instance carrying a `string_type`.
+/// @param params The Bloom filter parameters.
+/// @param seeds The seeds for the Bloom filter hasher.
+/// @returns A type-erased pointer to a synopsis.
+/// @pre `caf::holds_alternative<string_type>(type)`.
+/// @relates string_synopsis
+template <class HashFunction>
+synopsis_ptr
+make_string_synopsis(vast::type type, bloom_filter_parameters params,
+                     std::vector<size_t> seeds = {}) {
+  VAST_ASSERT(caf::holds_alternative<string_type>(type));
+  auto x = make_bloom_filter<HashFunction>(std::move(params), std::move(seeds));
+  if (!x) {
+    VAST_WARNING_ANON(__func__, "failed to construct Bloom filter");
+    return nullptr;
+  }
+  using synopsis_type = string_synopsis<HashFunction>;
+  return caf::make_counted<synopsis_type>(std::move(type), std::move(*x));
+}
+
+/// Factory to construct a string synopsis. This overload looks for a type
+/// attribute containing the Bloom filter parameters and hash function seeds.
+/// Without such an attribute, it only constructs a synopsis for strings with
+/// the `#index=hash` attribute, and returns `nullptr` for all other strings.
+/// @tparam HashFunction The hash function to use for the Bloom filter.
+/// @param type A type instance carrying a `string_type`.
+/// @returns A type-erased pointer to a synopsis.
+/// @relates string_synopsis
+template <class HashFunction>
+synopsis_ptr make_string_synopsis(vast::type type, const caf::settings& opts) {
+  VAST_ASSERT(caf::holds_alternative<string_type>(type));
+  auto make = [](auto x, auto xs) {
+    return make_string_synopsis<HashFunction>(std::move(x), std::move(xs));
+  };
+  if (auto xs = parse_parameters(type))
+    return make(std::move(type), std::move(*xs));
+  auto index = find_attribute(type, "index");
+  if (!index || !index->value || *index->value != "hash")
+    return nullptr;
+  // Without explicit Bloom filter parameters, we use the maximum partition
+  // size of the index as upper bound for the expected number of keys.
+  using int_type = caf::config_value::integer;
+  if (auto max_part_size = caf::get_if<int_type>(&opts, "max-partition-size")) {
+    bloom_filter_parameters xs;
+    xs.n = *max_part_size;
+    xs.p = 0.01;
+    // Because VAST deserializes a synopsis with empty options, we augment the
+    // type with the synopsis options.
+    using namespace std::string_literals;
+    auto v = "bloomfilter("s + std::to_string(*xs.n) + ','
+             + std::to_string(*xs.p) + ')';
+    auto attrs = type.attributes();
+    attrs.emplace_back("synopsis", std::move(v));
+    auto t = type.attributes(std::move(attrs));
+    auto result = make(std::move(t), std::move(xs));
+    if (!result)
+      VAST_ERROR_ANON(
+        __func__, "failed to evaluate Bloom filter parameters:", xs.n, xs.p);
+    return result;
+  }
+  VAST_DEBUG_ANON(__func__, "could not determine Bloom filter parameters");
+  return nullptr;
+}
+
+} // namespace vast
@@ -0,0 +1,85 @@
+/******************************************************************************
+ *                    _   _____   __________                                  *
+ *                   | | / / _ | / __/_  __/     Visibility                   *
+ *                   | |/ / __ |_\ \  / /          Across                     *
+ *                   |___/_/ |_/___/ /_/       Space and Time                 *
+ *                                                                            *
+ * This file is part of VAST. It is subject to the license terms in the       *
+ * LICENSE file found in the top-level directory of this distribution and at  *
+ * http://vast.io/license. No part of VAST, including this file, may be       *
+ * copied, modified, propagated, or distributed except according to the terms *
+ * contained in the LICENSE file.                                             *
+ ******************************************************************************/
+
+#pragma once
+
+#include "vast/time.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vast::system {
+
+/// Chooses the number of events per table slice for a source. Small table
+/// slices keep the latency low for sources with a low event rate, while large
+/// table slices amortize the per-slice overhead in the downstream components.
+/// The controller sizes table slices such that filling one takes roughly the
+/// target latency at the observed event rate, and grows them while the sinks
+/// fall behind.
+class batch_size_controller {
+public:
+  /// Constructs a controller that always yields the same size.
+  /// @param size The number of events per table slice.
+  explicit batch_size_controller(size_t size);
+
+  /// Constructs a controller that adapts the size within bounds.
+  /// @param min_size The lower bound for the number of events per table slice.
+  /// @param max_size The upper bound for the number of events per table slice.
+  /// @param target_latency The desired time to fill a single table slice.
+  /// @pre `0 < min_size && min_size <= max_size`
+  batch_size_controller(size_t min_size, size_t max_size,
+                        duration target_latency);
+
+  /// @returns the current number of events per table slice.
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  /// @returns the lower bound for the number of events per table slice.
+  size_t min_size() const noexcept {
+    return min_size_;
+  }
+
+  /// @returns the upper bound for the number of events per table slice.
+  size_t max_size() const noexcept {
+    return max_size_;
+  }
+
+  /// @returns whether the controller adapts the size at all.
+  bool adaptive() const noexcept {
+    return min_size_ < max_size_;
+  }
+
+  /// Adjusts the size after the source read from its input.
+  /// @param events The number of events that the read produced.
+  /// @param elapsed The time the read took, including waiting for input.
+  /// @param credit The number of table slices the sinks asked for.
+  /// @param timed_out Whether the read ended because the batch timeout
+  ///        fired before a table slice was full.
+  void observe(uint64_t events, duration elapsed, size_t credit,
+               bool timed_out);
+
+  /// @returns the smoothed event rate in events per second.
+  double rate() const noexcept {
+    return rate_;
+  }
+
+private:
+  size_t min_size_;
+  size_t max_size_;
+  size_t size_;
+  duration target_latency_;
+  double rate_ = 0.0;
+};
+
+} // namespace vast::system
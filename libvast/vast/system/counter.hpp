@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include "vast/candidate_checker.hpp"
 #include "vast/expression.hpp"
 #include "vast/fwd.hpp"
 #include "vast/ids.hpp"
@@ -71,7 +72,7 @@ private:
   ids hits_;
 
   /// Caches expr_ tailored to different layouts.
-  std::unordered_map<type, expression> checkers_;
+  std::unordered_map<type, candidate_checker> checkers_;
 };
 
 caf::behavior counter(caf::stateful_actor<counter_state>* self, expression expr,
@@ -43,7 +43,9 @@
 #include <caf/stream_source.hpp>
 #include <caf/streambuf.hpp>
 
+#include <algorithm>
 #include <unordered_map>
+#include <vector>
 
 namespace vast::system {
 
@@ -65,6 +67,25 @@ struct datagram_source_state : source_state<Reader, caf::io::broker> {
   /// Containes the amount of dropped packets since the last heartbeat.
   size_t dropped_packets = 0;
 
+  /// The extent of a datagram in `batch`.
+  struct datagram {
+    /// The offset one past the last byte of the datagram.
+    size_t end;
+
+    /// The number of lines in the datagram.
+    size_t lines;
+  };
+
+  /// The payloads of datagrams received since the last parsed batch, each
+  /// terminated by a newline.
+  std::vector<char> batch;
+
+  /// The datagrams in `batch`.
+  std::vector<datagram> batch_datagrams;
+
+  /// Whether a flush of `batch` is scheduled.
+  bool flush_scheduled = false;
+
   /// Timestamp when the source was started.
   caf::timestamp start_time;
 };
@@ -116,41 +137,104 @@ datagram_source(datagram_source_actor<Reader>* self,
     },
     // done?
     [=](const caf::unit_t&) { return self->state.done; });
+  auto schedule_flush = [=] {
+    auto& st = self->state;
+    if (st.flush_scheduled)
+      return;
+    st.flush_scheduled = true;
+    self->delayed_send(self, defaults::import::datagram_flush_interval,
+                       atom::flush_v);
+  };
+  // Parses the buffered datagrams in batches. Readers finish a table slice
+  // when reaching the end of their input, so parsing each datagram on its own
+  // would produce one table slice per datagram. We only parse as many
+  // datagrams as the stream has credit for, and keep the rest for later.
+  auto parse_batch = [=] {
+    auto& st = self->state;
+    if (st.batch_datagrams.empty())
+      return;
+    auto capacity = st.mgr->out().capacity();
+    if (capacity == 0) {
+      VAST_DEBUG(self, "waits for stream capacity to parse",
+                 st.batch_datagrams.size(), "datagrams");
+      schedule_flush();
+      return;
+    }
+    auto events = capacity * table_slice_size;
+    if (st.requested)
+      events = std::min(events, *st.requested - st.count);
+    // Select the datagrams whose lines fit into the credit. Datagrams always
+    // enter the reader as a whole, so that no event gets lost.
+    auto& first = st.batch_datagrams.front();
+    auto num_datagrams = size_t{1};
+    auto num_lines = first.lines;
+    for (; num_datagrams < st.batch_datagrams.size(); ++num_datagrams) {
+      auto lines = st.batch_datagrams[num_datagrams].lines;
+      if (num_lines + lines > events)
+        break;
+      num_lines += lines;
+    }
+    auto num_bytes = st.batch_datagrams[num_datagrams - 1].end;
+    VAST_DEBUG(self, "parses a batch of", num_datagrams, "datagrams");
+    auto t = timer::start(st.metrics);
+    caf::arraybuf<> buf{st.batch.data(), num_bytes};
+    st.reader.reset(std::make_unique<std::istream>(&buf));
+    auto push_slice = [&](table_slice_ptr slice) {
+      VAST_DEBUG(self, "produced a slice with", slice->rows(), "rows");
+      st.mgr->out().push(std::move(slice));
+    };
+    auto [err, produced] = st.reader.read(std::max(num_lines, size_t{1}),
+                                          table_slice_size, push_slice);
+    t.stop(produced);
+    st.count += produced;
+    st.batch.erase(st.batch.begin(), st.batch.begin() + num_bytes);
+    st.batch_datagrams.erase(st.batch_datagrams.begin(),
+                             st.batch_datagrams.begin() + num_datagrams);
+    for (auto& x : st.batch_datagrams)
+      x.end -= num_bytes;
+    if (st.requested && st.count >= *st.requested)
+      st.done = true;
+    if (err != caf::none && err != ec::end_of_input)
+      VAST_WARNING(self, "failed to parse datagrams:",
+                   self->system().render(err));
+    if (produced > 0)
+      st.mgr->push();
+    if (st.done) {
+      st.dropped_packets += st.batch_datagrams.size();
+      st.batch.clear();
+      st.batch_datagrams.clear();
+      st.send_report();
+    } else if (!st.batch_datagrams.empty()) {
+      schedule_flush();
+    }
+  };
   return {
     [=](caf::io::new_datagram_msg& msg) {
       // Check whether we can buffer more slices in the stream.
       VAST_DEBUG(self, "got a new datagram of size", msg.buf.size());
       auto& st = self->state;
-      auto t = timer::start(st.metrics);
-      auto capacity = st.mgr->out().capacity();
-      if (capacity == 0) {
+      if (st.done || st.mgr->out().capacity() == 0) {
         st.dropped_packets++;
         return;
       }
-      // Extract events until the source has exhausted its input or until
-      // we have completed a batch.
-      caf::arraybuf<> buf{msg.buf.data(), msg.buf.size()};
-      st.reader.reset(std::make_unique<std::istream>(&buf));
-      auto push_slice = [&](table_slice_ptr slice) {
-        VAST_DEBUG(self, "produced a slice with", slice->rows(), "rows");
-        st.mgr->out().push(std::move(slice));
-      };
-      auto events = capacity * table_slice_size;
-      if (st.requested)
-        events = std::min(events, *st.requested - st.count);
-      auto [err, produced] = st.reader.read(events, table_slice_size,
-                                            push_slice);
-      t.stop(produced);
-      st.count += produced;
-      if (st.requested && st.count >= *st.requested)
-        st.done = true;
-      if (err != caf::none && err != ec::end_of_input)
-        VAST_WARNING(self,
-                     "has not enough capacity left in stream, dropping input!");
-      if (produced > 0)
-        st.mgr->push();
-      if (st.done)
-        st.send_report();
+      st.batch.insert(st.batch.end(), msg.buf.begin(), msg.buf.end());
+      if (st.batch.empty() || st.batch.back() != '\n')
+        st.batch.push_back('\n');
+      auto lines = static_cast<size_t>(
+        std::count(msg.buf.begin(), msg.buf.end(), '\n'));
+      if (msg.buf.empty() || msg.buf.back() != '\n')
+        ++lines;
+      st.batch_datagrams.push_back({st.batch.size(), lines});
+      // Datagrams usually carry a single event, so a full table slice worth
+      // of datagrams is a good batch size.
+      if (st.batch_datagrams.size() >= table_slice_size)
+        parse_batch();
+      else
+        schedule_flush();
+    },
+    [=](atom::flush) {
+      self->state.flush_scheduled = false;
+      parse_batch();
     },
     [=](accountant_type accountant) {
       VAST_DEBUG(self, "sets accountant to", accountant);
@@ -204,6 +288,8 @@ datagram_source(datagram_source_actor<Reader>* self,
       if (st.dropped_packets > 0) {
         VAST_WARNING(self, "has no capacity left in stream and dropped",
                      st.dropped_packets, "packets");
+        self->send(st.accountant, std::string{st.name} + ".dropped-packets",
+                   uint64_t{st.dropped_packets});
         st.dropped_packets = 0;
       }
       if (!st.done)
@@ -46,12 +46,21 @@ struct evaluator_state {
   /// tree.
   void handle_missing_result(const offset& position, const caf::error& err);
 
+  /// Updates `predicate_hits` for a batch of predicates answered by the same
+  /// INDEXER and evaluates the expression tree at most once.
+  /// @param positions The positions of the predicates in the expression.
+  /// @param results The hits per predicate.
+  /// @param errors The error per predicate, if its lookup failed.
+  void handle_results(const std::vector<offset>& positions,
+                      const std::vector<ids>& results,
+                      const std::vector<caf::error>& errors);
+
   /// Evaluates the predicate-tree and may produces new deltas.
   void evaluate();
 
-  /// Decrements the `pending_responses` and sends 'done' to the client when it
-  /// reaches 0.
-  void decrement_pending();
+  /// Decrements the `pending_responses` by `n` and sends 'done' to the client
+  /// when it reaches 0.
+  void decrement_pending(size_t n = 1);
 
   /// Returns the `predicate_hits` entry for `pred` or `nullptr`.
   predicate_hits_map::mapped_type* hits_for(const offset& position);
@@ -13,17 +13,21 @@
 
 #pragma once
 
+#include "vast/data.hpp"
 #include "vast/expression.hpp"
 #include "vast/fwd.hpp"
 #include "vast/system/node.hpp"
+#include "vast/time.hpp"
 #include "vast/type.hpp"
 
 #include <caf/actor.hpp>
+#include <caf/actor_addr.hpp>
 #include <caf/fwd.hpp>
 
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace vast::system {
 
@@ -33,6 +37,20 @@ struct explorer_state {
     uint64_t per_result;
   };
 
+  /// A result of the initial query around which the explorer looks for
+  /// context.
+  struct seed {
+    /// The timestamp of the result.
+    vast::time timestamp;
+
+    /// The number of context events attributed to this result.
+    uint64_t num_results = 0;
+  };
+
+  /// The seeds of a single context query, grouped by their value of the `by`
+  /// field (nil without `by`) and sorted by timestamp.
+  using seed_map = std::unordered_map<data, std::vector<seed>>;
+
   static inline constexpr const char* name = "explorer";
 
   explorer_state(caf::event_based_actor* self);
@@ -40,6 +58,19 @@ struct explorer_state {
   /// Send the results to the sink, after removing duplicates.
   void forward_results(vast::table_slice_ptr slice);
 
+  /// Builds a single query for the contexts of many seeds. Overlapping time
+  /// boxes get merged, and the values of the `by` field become a list for
+  /// the `in` operator. The time boxes span all values of the `by` field, so
+  /// the query may return events outside the context of their seeds, which
+  /// `forward_context` filters out.
+  /// @pre `!seeds.empty()`
+  expression make_query(const seed_map& seeds) const;
+
+  /// Sends the rows of a context query result to the sink that lie in the
+  /// context of at least one seed, unless all of these seeds already reached
+  /// the per-result limit.
+  void forward_context(seed_map& seeds, vast::table_slice_ptr slice);
+
   /// Maximum number of events to output.
   event_limits limits;
 
@@ -59,6 +90,9 @@ struct explorer_state {
   /// for the purpose of deduplication.
   std::unordered_set<size_t> returned_ids;
 
+  /// The seeds of the running context queries by EXPORTER.
+  std::unordered_map<caf::actor_addr, seed_map> queries;
+
   /// A tracking counter of spawned exporters. Used for lifetime management.
   size_t running_exporters = 0;
 
@@ -80,7 +114,8 @@ struct explorer_state {
 };
 
 /// The EXPLORER receives table slices and constructs new queries for a time box
-/// around each result.
+/// around each result. It issues one query per table slice of the initial
+/// query result, and assigns the results back to the individual rows.
 /// @param self The actor handle.
 /// @param node The node actor to spawn exporters in.
 /// @param before Size of the time box prior to each result.
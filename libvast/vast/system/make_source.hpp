@@ -28,6 +28,7 @@
 #include "vast/logger.hpp"
 #include "vast/schema.hpp"
 #include "vast/system/accountant.hpp"
+#include "vast/system/batch_size_controller.hpp"
 #include "vast/system/datagram_source.hpp"
 #include "vast/system/signal_monitor.hpp"
 #include "vast/system/source.hpp"
@@ -97,6 +98,16 @@ make_source(const Actor& self, caf::actor_system& sys, const invocation& inv,
     = get_or(options, "import.batch-size", defaults::import::table_slice_size);
   if (slice_size == 0)
     slice_size = std::numeric_limits<decltype(slice_size)>::max();
+  auto batch_size = batch_size_controller{slice_size};
+  if (auto min_slice_size = caf::get_if<size_t>(&options,
+                                                 "import.min-batch-size")) {
+    if (*min_slice_size == 0 || *min_slice_size > slice_size)
+      return make_error(ec::invalid_configuration,
+                        "import.min-batch-size must be between 1 and "
+                        "import.batch-size");
+    batch_size = batch_size_controller{*min_slice_size, slice_size,
+                                       defaults::import::batch_latency};
+  }
   // Parse schema local to the import command.
   auto schema = get_schema(options, category);
   if (!schema)
@@ -153,23 +164,30 @@ make_source(const Actor& self, caf::actor_system& sys, const invocation& inv,
     return make_error(ec::invalid_result, "failed to spawn reader");
   if (slice_size == std::numeric_limits<decltype(slice_size)>::max())
     VAST_VERBOSE_ANON(reader->name(), "produces", slice_type, "table slices");
+  else if (batch_size.adaptive() && !udp_port)
+    VAST_VERBOSE_ANON(reader->name(), "produces", slice_type,
+                      "table slices of", batch_size.min_size(), "to",
+                      slice_size, "events");
   else
     VAST_VERBOSE_ANON(reader->name(), "produces", slice_type,
                       "table slices of at most", slice_size, "events");
   // Spawn the source, falling back to the default spawn function.
   auto local_schema = schema ? std::move(*schema) : vast::schema{};
   auto type_filter = type ? std::move(*type) : std::string{};
+  // Datagram sources batch by the number of received datagrams, so they
+  // always use the upper bound of the table slice size.
   auto src =
     [&](auto&&... args) {
       if (udp_port)
         return sys.middleman().spawn_broker<SpawnOptions>(
-          datagram_source<Reader>, *udp_port,
+          datagram_source<Reader>, *udp_port, std::move(*reader), slice_size,
           std::forward<decltype(args)>(args)...);
       else
-        return sys.spawn<SpawnOptions>(source<Reader>,
+        return sys.spawn<SpawnOptions>(source<Reader>, std::move(*reader),
+                                       std::move(batch_size),
                                        std::forward<decltype(args)>(args)...);
-    }(std::move(*reader), slice_size, max_events, std::move(type_registry),
-      std::move(local_schema), std::move(type_filter), std::move(accountant));
+    }(max_events, std::move(type_registry), std::move(local_schema),
+      std::move(type_filter), std::move(accountant));
   VAST_ASSERT(src);
   // Attempt to parse the remainder as an expression.
   if (!inv.arguments.empty()) {
@@ -30,6 +30,7 @@
 #include "vast/logger.hpp"
 #include "vast/schema.hpp"
 #include "vast/system/accountant.hpp"
+#include "vast/system/batch_size_controller.hpp"
 #include "vast/system/instrumentation.hpp"
 #include "vast/system/report.hpp"
 #include "vast/system/type_registry.hpp"
@@ -128,6 +129,9 @@ struct source_state {
   /// Current metrics for the accountant.
   measurement metrics;
 
+  /// Chooses the number of events per table slice.
+  batch_size_controller batch_size{defaults::import::table_slice_size};
+
   /// Indicates whether the stream source is done.
   bool done;
 
@@ -205,6 +209,12 @@ struct source_state {
       metrics = measurement{};
       self->send(accountant, std::move(r));
     }
+    // Send the table slice size chosen by the source.
+    if (batch_size.adaptive()) {
+      auto key = std::string{name} + ".batch-size";
+      auto r = report{{std::move(key), uint64_t{batch_size.size()}}};
+      self->send(accountant, std::move(r));
+    }
   }
 };
 
@@ -212,7 +222,7 @@ struct source_state {
 /// @tparam Reader The concrete source implementation.
 /// @param self The actor handle.
 /// @param reader The reader instance.
-/// @param table_slice_size The maximum size for a table slice.
+/// @param batch_size Chooses the number of events per table slice.
 /// @param max_events The optional maximum amount of events to import.
 /// @param type_registry The actor handle for the type-registry component.
 /// @oaram local_schema Additional local schemas to consider.
@@ -221,7 +231,7 @@ struct source_state {
 template <class Reader>
 caf::behavior
 source(caf::stateful_actor<source_state<Reader>>* self, Reader reader,
-       size_t table_slice_size, caf::optional<size_t> max_events,
+       batch_size_controller batch_size, caf::optional<size_t> max_events,
        type_registry_type type_registry, vast::schema local_schema,
        std::string type_filter, accountant_type accountant) {
   VAST_TRACE(VAST_ARG(self));
@@ -230,6 +240,7 @@ source(caf::stateful_actor<source_state<Reader>>* self, Reader reader,
   st.init(self, std::move(reader), std::move(max_events),
           std::move(type_registry), std::move(local_schema),
           std::move(type_filter), std::move(accountant));
+  st.batch_size = std::move(batch_size);
   self->set_exit_handler([=](const caf::exit_msg& msg) {
     VAST_VERBOSE(self, "received EXIT from", msg.source);
     self->state.done = true;
@@ -249,14 +260,18 @@ source(caf::stateful_actor<source_state<Reader>>* self, Reader reader,
       // we have completed a batch.
       auto push_slice = [&](table_slice_ptr x) { out.push(std::move(x)); };
       // We can produce up to num * table_slice_size events per run.
+      auto table_slice_size = st.batch_size.size();
       auto events = num * table_slice_size;
       if (st.requested)
         events = std::min(events, *st.requested - st.count);
+      auto start = stopwatch::now();
       auto t = timer::start(st.metrics);
       auto [err, produced] = st.reader.read(events, table_slice_size,
                                             push_slice);
       t.stop(produced);
       st.count += produced;
+      st.batch_size.observe(produced, stopwatch::now() - start, num,
+                            err == vast::ec::timeout);
       auto force_emit_batches = [&] {
         st.mgr->out().fan_out_flush();
         st.mgr->out().force_emit_batches();
@@ -344,6 +359,7 @@ source(caf::stateful_actor<source_state<Reader>>* self, Reader reader,
         if (st.reader_initialized)
           put(src, "format", st.reader.name());
         put(src, "produced", st.count);
+        put(src, "batch-size", st.batch_size.size());
         auto& xs = put_list(result, "sources");
         xs.emplace_back(std::move(src));
       }
@@ -134,6 +134,12 @@ public:
   /// Appends all values in column `col` to `idx`.
   virtual void append_column_to_index(size_type col, value_index& idx) const;
 
+  /// Evaluates the predicate `x op rhs` for every value `x` in column `col`
+  /// and appends the results to `result`, one bit per row. The default
+  /// implementation compares the canonical value of every cell.
+  virtual void evaluate_column(size_type col, relational_operator op,
+                               const data& rhs, ids& result) const;
+
   // -- properties -------------------------------------------------------------
 
   /// @returns the table slice header.
@@ -234,19 +240,31 @@ caf::error inspect(caf::serializer& sink, table_slice_ptr& ptr);
 /// @relates table_slice
 caf::error inspect(caf::deserializer& source, table_slice_ptr& ptr);
 
-/// Packs a table slice into a flatbuffer.
+/// Packs a table slice without its layout into a flatbuffer.
 /// @param builder The builder to pack *x* into.
 /// @param x The table slice to pack.
+/// @param layout_id The position of the layout of *x* in the enclosing
+///        segment.
 /// @returns The flatbuffer offset in *builder*.
 caf::expected<flatbuffers::Offset<fbs::TableSliceBuffer>>
-pack(flatbuffers::FlatBufferBuilder& builder, table_slice_ptr x);
+pack(flatbuffers::FlatBufferBuilder& builder, table_slice_ptr x,
+     uint32_t layout_id);
 
-/// Unpacks a table slice from a flatbuffer.
+/// Unpacks a table slice that contains its layout from a flatbuffer, as
+/// written by older versions.
 /// @param x The flatbuffer to unpack.
 /// @param y The target to unpack *x* into.
 /// @returns An error iff the operation fails.
 caf::error unpack(const fbs::TableSlice& x, table_slice_ptr& y);
 
+/// Unpacks a table slice from a flatbuffer.
+/// @param x The flatbuffer to unpack.
+/// @param layout The layout of the table slice.
+/// @param y The target to unpack *x* into.
+/// @returns An error iff the operation fails.
+caf::error unpack(const fbs::TableSlice& x, record_type layout,
+                  table_slice_ptr& y);
+
 // -- operations ---------------------------------------------------------------
 
 /// Constructs table slices filled with random content for testing purposes.
@@ -322,7 +340,8 @@ to_data(const table_slice& slice, size_t first_row = 0, size_t num_rows = 0);
 std::vector<std::vector<data>>
 to_data(const std::vector<table_slice_ptr>& slices);
 
-/// Evaluates an expression over a table slice by applying it row-wise.
+/// Evaluates an expression over a table slice one column at a time. To check
+/// many slices of the same layout, compile a `candidate_checker` once instead.
 /// @param expr The expression to evaluate.
 /// @param slice The table slice to apply *expr* on.
 /// @returns The set of row IDs in *slice* for which *expr* yields true.
@@ -13,13 +13,20 @@
 
 #pragma once
 
+#include "vast/address.hpp"
+#include "vast/aliases.hpp"
 #include "vast/fwd.hpp"
+#include "vast/span.hpp"
 #include "vast/view.hpp"
 
 #include <caf/make_counted.hpp>
 #include <caf/ref_counted.hpp>
+#include <caf/variant.hpp>
 
+#include <cstdint>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace vast {
 
@@ -27,6 +34,31 @@ namespace vast {
 /// @relates table_slice
 class table_slice_builder : public caf::ref_counted {
 public:
+  // -- member types -----------------------------------------------------------
+
+  /// The typed values of a column that was appended with one of the
+  /// `append_*` functions.
+  using column_values
+    = caf::variant<span<const integer>, span<const count>,
+                   span<const std::string_view>, span<const address>>;
+
+  /// A column appended with one of the `append_*` functions.
+  struct column {
+    /// The values of the column.
+    column_values values;
+
+    /// Either empty or one byte per value, where 0 marks a `nil` value.
+    span<const uint8_t> valid;
+
+    /// @returns the number of values in the column.
+    size_t size() const;
+
+    /// @returns whether the value at position *i* is `nil`.
+    bool is_nil(size_t i) const {
+      return !valid.empty() && valid[i] == 0;
+    }
+  };
+
   // -- constructors, destructors, and assignment operators --------------------
 
   table_slice_builder(record_type layout);
@@ -59,6 +91,37 @@ public:
     return add(x0) && add(x1) && (add(xs) && ...);
   }
 
+  /// Appends a column of values to the builder. This adds values a column at
+  /// a time instead of a row at a time: all columns must be appended in
+  /// layout order with the same number of values, and the rows become part of
+  /// the slice once the last column of the layout was appended. The values
+  /// must stay valid until then. The type of a column must match the type of
+  /// the corresponding field in the layout, and appending columns must not be
+  /// interleaved with adding a row via `add`.
+  /// @param col The index of the column in the layout.
+  /// @param xs The values of the column.
+  /// @param valid Either empty or one byte per value in *xs*, where 0 means
+  ///              that the value is `nil`.
+  /// @returns `true` on success. On failure, the builder discards all columns
+  ///          appended since the last complete set of columns.
+  [[nodiscard]] bool
+  append_integers(size_t col, span<const integer> xs,
+                  span<const uint8_t> valid = {});
+
+  /// @copydoc append_integers
+  [[nodiscard]] bool append_counts(size_t col, span<const count> xs,
+                                   span<const uint8_t> valid = {});
+
+  /// @copydoc append_integers
+  [[nodiscard]] bool
+  append_strings(size_t col, span<const std::string_view> xs,
+                 span<const uint8_t> valid = {});
+
+  /// @copydoc append_integers
+  [[nodiscard]] bool
+  append_addresses(size_t col, span<const address> xs,
+                   span<const uint8_t> valid = {});
+
   /// Constructs a table_slice from the currently accumulated state. After
   /// calling this function, implementations must reset their internal state
   /// such that subsequent calls to add will restart with a new table_slice.
@@ -92,8 +155,20 @@ protected:
   /// @returns `true` on success.
   virtual bool add_impl(data_view x) = 0;
 
+  /// Adds the rows of a complete set of appended columns to the builder. The
+  /// default implementation adds the values row by row via `add_impl`.
+  /// @param xs One column per field of the layout with *rows* values each.
+  /// @param rows The number of rows.
+  /// @returns `true` on success.
+  virtual bool add_columns_impl(const std::vector<column>& xs, size_t rows);
+
 private:
+  bool append(size_t col, column x);
+
   record_type layout_;
+
+  /// Columns appended since the last complete set of columns.
+  std::vector<column> columns_;
 };
 
 /// @relates table_slice_builder
@@ -19,15 +19,20 @@
 #include "vast/concept/printable/vast/data.hpp"
 #include "vast/concept/printable/vast/operator.hpp"
 #include "vast/detail/assert.hpp"
+#include "vast/detail/heterogeneous_string_hash.hpp"
 #include "vast/detail/overload.hpp"
 #include "vast/die.hpp"
 #include "vast/error.hpp"
 #include "vast/ewah_bitmap.hpp"
+#include "vast/fbs/value_index.hpp"
+#include "vast/fbs/version.hpp"
 #include "vast/ids.hpp"
 #include "vast/type.hpp"
 #include "vast/value_index_factory.hpp"
 #include "vast/view.hpp"
 
+#include <caf/binary_deserializer.hpp>
+#include <caf/binary_serializer.hpp>
 #include <caf/deserializer.hpp>
 #include <caf/error.hpp>
 #include <caf/expected.hpp>
@@ -36,7 +41,13 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <type_traits>
+#include <vector>
+
+#include <flatbuffers/flatbuffers.h>
+#include <tsl/robin_map.h>
 
 namespace vast {
 
@@ -73,6 +84,15 @@ public:
   /// @returns The result of the lookup or an error upon failure.
   caf::expected<ids> lookup(relational_operator op, data_view x) const;
 
+  /// Looks up a batch of values under the same relational operator. This is
+  /// equivalent to invoking `lookup` for every value, but allows the concrete
+  /// index to share work between the lookups.
+  /// @param op The relation operator.
+  /// @param xs The values to lookup.
+  /// @returns One result per value in *xs* or an error upon failure.
+  caf::expected<std::vector<ids>>
+  lookup_batch(relational_operator op, const std::vector<data_view>& xs) const;
+
   /// Merges another value index with this one.
   /// @param other The value index to merge.
   /// @returns `true` on success.
@@ -94,16 +114,46 @@ public:
 
   virtual caf::error deserialize(caf::deserializer& source);
 
+  /// The union type and offset of the packed state of a concrete index.
+  using packed_state
+    = std::pair<fbs::ValueIndexState, flatbuffers::Offset<void>>;
+
+  friend caf::expected<flatbuffers::Offset<fbs::ValueIndex>>
+  pack(flatbuffers::FlatBufferBuilder& builder, const value_index& x);
+
+  friend caf::error unpack(const fbs::ValueIndex& x, value_index& y);
+
 protected:
   const ewah_bitmap& mask() const;
   const ewah_bitmap& none() const;
 
+  /// Looks up a batch of non-nil values. The default implementation performs
+  /// one lookup per value.
+  virtual caf::expected<std::vector<ids>>
+  lookup_batch_impl(relational_operator op,
+                    const std::vector<data_view>& xs) const;
+
 private:
   virtual bool append_impl(data_view x, id pos) = 0;
 
   virtual caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const = 0;
 
+  /// Restricts the result of a concrete lookup to the IDs of this index.
+  ids finish_lookup(relational_operator op, ids result) const;
+
+  /// Packs the state of the concrete index implementation into a flatbuffer.
+  /// @param builder The builder to pack the state into.
+  /// @returns The packed state or an error if the implementation does not
+  ///          support flatbuffers.
+  virtual caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const;
+
+  /// Unpacks the state of the concrete index implementation.
+  /// @param x The flatbuffer to unpack.
+  /// @returns An error iff the operation failed.
+  virtual caf::error unpack_impl(const fbs::ValueIndex& x);
+
   ewah_bitmap mask_;         ///< The position of all values excluding nil.
   ewah_bitmap none_;         ///< The positions of nil values.
   const vast::type type_;    ///< The type of this index.
@@ -122,8 +172,208 @@ caf::error inspect(caf::serializer& sink, const value_index_ptr& x);
 /// @relates value_index
 caf::error inspect(caf::deserializer& source, value_index_ptr& x);
 
+/// Packs a value index into a flatbuffer.
+/// @param builder The builder to pack *x* into.
+/// @param x The value index to pack.
+/// @returns The flatbuffer offset in *builder*.
+/// @relates value_index
+caf::expected<flatbuffers::Offset<fbs::ValueIndex>>
+pack(flatbuffers::FlatBufferBuilder& builder, const value_index& x);
+
+/// @relates value_index
+caf::expected<flatbuffers::Offset<fbs::ValueIndex>>
+pack(flatbuffers::FlatBufferBuilder& builder, const value_index_ptr& x);
+
+/// Unpacks a value index from a flatbuffer into an existing index.
+/// @param x The flatbuffer to unpack.
+/// @param y The value index to unpack *x* into.
+/// @pre The type of *y* must be the type stored in *x*.
+/// @relates value_index
+caf::error unpack(const fbs::ValueIndex& x, value_index& y);
+
+/// Unpacks a value index from a flatbuffer and constructs a new index with
+/// the stored type and options.
+/// @param x The flatbuffer to unpack.
+/// @param y The value index to unpack *x* into.
+/// @relates value_index
+caf::error unpack(const fbs::ValueIndex& x, value_index_ptr& y);
+
 namespace detail {
 
+// -- flatbuffer helpers -------------------------------------------------------
+
+/// Packs an object into a flatbuffer byte vector via CAF serialization.
+template <class T>
+caf::expected<flatbuffers::Offset<flatbuffers::Vector<uint8_t>>>
+pack_caf_binary(flatbuffers::FlatBufferBuilder& builder, const T& x) {
+  std::vector<char> buffer;
+  caf::binary_serializer sink{nullptr, buffer};
+  if (auto err = sink(x))
+    return err;
+  auto ptr = reinterpret_cast<const uint8_t*>(buffer.data());
+  return builder.CreateVector(ptr, buffer.size());
+}
+
+/// Unpacks an object from a flatbuffer byte vector via CAF deserialization.
+template <class T>
+caf::error unpack_caf_binary(const flatbuffers::Vector<uint8_t>* x, T& y) {
+  if (!x)
+    return make_error(ec::format_error, "missing CAF binary data");
+  auto ptr = reinterpret_cast<const char*>(x->data());
+  caf::binary_deserializer source{nullptr, ptr, x->size()};
+  return source(y);
+}
+
+/// Packs the raw blocks of an EWAH bitmap.
+flatbuffers::Offset<fbs::EWAHBitmap>
+pack_bitmap(flatbuffers::FlatBufferBuilder& builder, const ewah_bitmap& x);
+
+/// Packs a type-erased bitmap.
+/// @pre The concrete type of *x* is ::ewah_bitmap.
+caf::expected<flatbuffers::Offset<fbs::EWAHBitmap>>
+pack_bitmap(flatbuffers::FlatBufferBuilder& builder, const bitmap& x);
+
+/// Unpacks an EWAH bitmap from its raw blocks.
+caf::error unpack_bitmap(const fbs::EWAHBitmap* x, ewah_bitmap& y);
+
+/// Unpacks a type-erased bitmap from its raw blocks.
+caf::error unpack_bitmap(const fbs::EWAHBitmap* x, bitmap& y);
+
+template <class Coder>
+caf::expected<flatbuffers::Offset<fbs::Coder>>
+pack_coder(flatbuffers::FlatBufferBuilder& builder, const Coder& x) {
+  std::vector<flatbuffers::Offset<fbs::EWAHBitmap>> bitmaps;
+  auto add = [&](const auto& bm) -> caf::error {
+    caf::expected<flatbuffers::Offset<fbs::EWAHBitmap>> offset
+      = pack_bitmap(builder, bm);
+    if (!offset)
+      return offset.error();
+    bitmaps.push_back(*offset);
+    return caf::none;
+  };
+  if constexpr (is_singleton_coder<Coder>{}) {
+    if (auto err = add(x.storage()))
+      return err;
+  } else {
+    bitmaps.reserve(x.storage().size());
+    for (auto& bm : x.storage())
+      if (auto err = add(bm))
+        return err;
+  }
+  auto bitmaps_offset = builder.CreateVector(bitmaps);
+  return fbs::CreateCoder(builder, x.size(), bitmaps_offset);
+}
+
+template <class Coder>
+caf::error unpack_coder(const fbs::Coder* x, Coder& y) {
+  if (!x || !x->bitmaps())
+    return make_error(ec::format_error, "missing coder");
+  std::vector<typename Coder::bitmap_type> bitmaps(x->bitmaps()->size());
+  for (size_t i = 0; i < bitmaps.size(); ++i)
+    if (auto err = unpack_bitmap(x->bitmaps()->Get(i), bitmaps[i]))
+      return err;
+  if constexpr (is_singleton_coder<Coder>{}) {
+    if (bitmaps.size() != 1)
+      return make_error(ec::format_error, "singleton coder needs 1 bitmap");
+    y = Coder{std::move(bitmaps[0])};
+  } else {
+    y = Coder{x->size(), std::move(bitmaps)};
+  }
+  return caf::none;
+}
+
+template <class T, class Coder, class Binner>
+caf::expected<flatbuffers::Offset<fbs::BitmapIndex>>
+pack_bitmap_index(flatbuffers::FlatBufferBuilder& builder,
+                  const bitmap_index<T, Coder, Binner>& x) {
+  std::vector<uint64_t> values;
+  std::vector<flatbuffers::Offset<fbs::Coder>> coders;
+  auto add = [&](const auto& coder) -> caf::error {
+    auto offset = pack_coder(builder, coder);
+    if (!offset)
+      return offset.error();
+    coders.push_back(*offset);
+    return caf::none;
+  };
+  if constexpr (is_multi_level_coder<Coder>{}) {
+    auto& b = x.coder().get_base();
+    values.assign(b.begin(), b.end());
+    for (auto& coder : x.coder().storage())
+      if (auto err = add(coder))
+        return err;
+  } else {
+    if (auto err = add(x.coder()))
+      return err;
+  }
+  auto base_offset = builder.CreateVector(values);
+  auto coders_offset = builder.CreateVector(coders);
+  return fbs::CreateBitmapIndex(builder, base_offset, coders_offset);
+}
+
+template <class T, class Coder, class Binner>
+caf::error unpack_bitmap_index(const fbs::BitmapIndex* x,
+                               bitmap_index<T, Coder, Binner>& y) {
+  using index_type = bitmap_index<T, Coder, Binner>;
+  if (!x || !x->coders())
+    return make_error(ec::format_error, "missing bitmap index");
+  if constexpr (is_multi_level_coder<Coder>{}) {
+    if (!x->base() || x->base()->size() != x->coders()->size())
+      return make_error(ec::format_error, "base and coders mismatch");
+    auto b = base{base::vector_type(x->base()->begin(), x->base()->end())};
+    std::vector<typename Coder::coder_type> coders(x->coders()->size());
+    for (size_t i = 0; i < coders.size(); ++i)
+      if (auto err = unpack_coder(x->coders()->Get(i), coders[i]))
+        return err;
+    y = index_type{Coder{std::move(b), std::move(coders)}};
+  } else {
+    if (x->coders()->size() != 1)
+      return make_error(ec::format_error, "expected exactly one coder");
+    Coder coder;
+    if (auto err = unpack_coder(x->coders()->Get(0), coder))
+      return err;
+    y = index_type{std::move(coder)};
+  }
+  return caf::none;
+}
+
+/// Packs a sequence of bitmap indexes.
+template <class Container>
+caf::expected<flatbuffers::Offset<
+  flatbuffers::Vector<flatbuffers::Offset<fbs::BitmapIndex>>>>
+pack_bitmap_indexes(flatbuffers::FlatBufferBuilder& builder,
+                    const Container& xs) {
+  std::vector<flatbuffers::Offset<fbs::BitmapIndex>> offsets;
+  offsets.reserve(xs.size());
+  for (auto& x : xs) {
+    auto offset = pack_bitmap_index(builder, x);
+    if (!offset)
+      return offset.error();
+    offsets.push_back(*offset);
+  }
+  return builder.CreateVector(offsets);
+}
+
+/// Unpacks a sequence of bitmap indexes. Resizes *ys* if it is a vector, and
+/// requires a matching size otherwise.
+template <class Container>
+caf::error unpack_bitmap_indexes(
+  const flatbuffers::Vector<flatbuffers::Offset<fbs::BitmapIndex>>* xs,
+  Container& ys) {
+  if (!xs)
+    return make_error(ec::format_error, "missing bitmap indexes");
+  if constexpr (std::is_same_v<Container,
+                               std::vector<typename Container::value_type>>)
+    ys.resize(xs->size());
+  else if (ys.size() != xs->size())
+    return make_error(ec::format_error, "bitmap index count mismatch");
+  for (size_t i = 0; i < ys.size(); ++i)
+    if (auto err = unpack_bitmap_index(xs->Get(i), ys[i]))
+      return err;
+  return caf::none;
+}
+
+// -- lookup helpers -----------------------------------------------------------
+
 template <class Index, class Sequence>
 caf::expected<ids>
 container_lookup_impl(const Index& idx, relational_operator op,
@@ -164,6 +414,28 @@ container_lookup(const Index& idx, relational_operator op, view<list> xs) {
   return container_lookup_impl(idx, op, *xs);
 }
 
+/// Performs a membership lookup with a single batched lookup of all elements
+/// instead of one lookup per element.
+/// @param element_op The operator to apply to every element of *xs*.
+template <class Index>
+caf::expected<ids>
+container_lookup_batch(const Index& idx, relational_operator op, view<list> xs,
+                       relational_operator element_op = equal) {
+  VAST_ASSERT(xs);
+  if (!(op == in || op == not_in))
+    return make_error(ec::unsupported_operator, op);
+  auto values = std::vector<data_view>(xs->begin(), xs->end());
+  auto hits = idx.lookup_batch(element_op, values);
+  if (!hits)
+    return hits.error();
+  ids result = bitmap{idx.offset(), false};
+  for (auto& x : *hits)
+    result |= x;
+  if (op == not_in)
+    result.flip();
+  return result;
+}
+
 } // namespace detail
 
 /// An index for arithmetic values.
@@ -287,6 +559,22 @@ private:
     return caf::visit(f, d);
   };
 
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override {
+    auto index = detail::pack_bitmap_index(builder, bmi_);
+    if (!index)
+      return index.error();
+    auto state = fbs::CreateArithmeticIndex(builder, *index);
+    return packed_state{fbs::ValueIndexState::arithmetic, state.Union()};
+  }
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override {
+    auto state = x.state_as_arithmetic();
+    if (!state)
+      return make_error(ec::format_error, "expected arithmetic index state");
+    return detail::unpack_bitmap_index(state->index(), bmi_);
+  }
+
   bitmap_index_type bmi_;
 };
 
@@ -315,11 +603,66 @@ private:
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override;
+
   size_t max_length_;
   length_bitmap_index length_;
   std::vector<char_bitmap_index> chars_;
 };
 
+/// An index for strings with a small number of distinct values. The index
+/// maps each distinct string to an identifier and keeps one bitmap per
+/// identifier, such that equality lookups boil down to a single bitmap fetch.
+/// When the number of distinct values exceeds the configured maximum, the
+/// index transparently converts itself into a ::string_index.
+class dictionary_index : public value_index {
+public:
+  /// The index which holds the dictionary identifiers.
+  using index = bitmap_index<uint32_t, equality_coder<ewah_bitmap>>;
+
+  /// Constructs a dictionary index.
+  /// @param t An instance of `string_type`.
+  /// @param opts Runtime context for index parameterization.
+  explicit dictionary_index(vast::type t, caf::settings opts = {});
+
+  caf::error serialize(caf::serializer& sink) const override;
+
+  caf::error deserialize(caf::deserializer& source) override;
+
+  /// @returns the number of distinct values, or 0 after the index has fallen
+  /// back to a ::string_index.
+  size_t cardinality() const;
+
+  /// @returns `true` if the index has fallen back to a ::string_index.
+  bool is_fallback() const;
+
+private:
+  bool append_impl(data_view x, id pos) override;
+
+  caf::expected<ids>
+  lookup_impl(relational_operator op, data_view x) const override;
+
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override;
+
+  /// Replaces the dictionary with a ::string_index containing all values
+  /// appended so far.
+  void make_fallback();
+
+  size_t max_cardinality_;
+  std::vector<std::string> dictionary_;
+  tsl::robin_map<std::string, uint32_t, detail::heterogeneous_string_hash,
+                 detail::heterogeneous_string_equal>
+    ids_;
+  index index_;
+  std::unique_ptr<string_index> fallback_;
+};
+
 /// An index for enumerations.
 class enumeration_index : public value_index {
 public:
@@ -337,6 +680,11 @@ private:
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override;
+
   index index_;
 };
 
@@ -358,6 +706,15 @@ private:
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  caf::expected<std::vector<ids>>
+  lookup_batch_impl(relational_operator op,
+                    const std::vector<data_view>& xs) const override;
+
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override;
+
   std::array<byte_index, 16> bytes_;
   type_index v4_;
 };
@@ -379,6 +736,11 @@ private:
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override;
+
   address_index network_;
   prefix_index length_;
 };
@@ -410,6 +772,11 @@ private:
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override;
+
   number_index num_;
   protocol_index proto_;
 };
@@ -436,6 +803,11 @@ private:
   caf::expected<ids>
   lookup_impl(relational_operator op, data_view x) const override;
 
+  caf::expected<packed_state>
+  pack_impl(flatbuffers::FlatBufferBuilder& builder) const override;
+
+  caf::error unpack_impl(const fbs::ValueIndex& x) override;
+
   std::vector<value_index_ptr> elements_;
   size_t max_size_;
   size_bitmap_index size_;
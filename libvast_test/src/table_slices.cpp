@@ -15,6 +15,7 @@
 
 #include "vast/chunk.hpp"
 #include "vast/concept/parseable/to.hpp"
+#include "vast/concept/parseable/vast/address.hpp"
 #include "vast/concept/parseable/vast/data.hpp"
 #include "vast/span.hpp"
 #include "vast/table_slice_factory.hpp"
@@ -167,6 +168,7 @@ void table_slices::run() {
   test_message_serialization();
   test_load_from_chunk();
   test_append_column_to_index();
+  test_append_columns();
 }
 
 caf::binary_deserializer table_slices::make_source() {
@@ -291,4 +293,46 @@ void table_slices::test_append_column_to_index() {
   CHECK_EQUAL(unbox(idx->lookup(less, make_view(3))), make_ids({1}));
 }
 
+void table_slices::test_append_columns() {
+  MESSAGE(">> test table_slice_builder::append_*");
+  record_type columnar_layout{{"i", integer_type{}},
+                              {"c", count_type{}},
+                              {"s", string_type{}},
+                              {"a", address_type{}}};
+  auto make_builder = [&] {
+    return factory<table_slice_builder>::make(builder->implementation_id(),
+                                              columnar_layout);
+  };
+  std::vector<integer> is{1, -2, 3};
+  std::vector<count> cs{4, 5, 6};
+  std::vector<std::string_view> ss{"foo", "", "bar"};
+  std::vector<address> as{unbox(to<address>("10.0.0.1")),
+                          unbox(to<address>("10.0.0.2")),
+                          unbox(to<address>("::1"))};
+  std::vector<uint8_t> valid{1, 0, 1};
+  auto columnar = make_builder();
+  REQUIRE_NOT_EQUAL(columnar, nullptr);
+  CHECK(columnar->append_integers(0, is));
+  CHECK(columnar->append_counts(1, cs, valid));
+  CHECK(columnar->append_strings(2, ss));
+  CHECK_EQUAL(columnar->rows(), 0u);
+  CHECK(columnar->append_addresses(3, as));
+  CHECK_EQUAL(columnar->rows(), 3u);
+  auto rowwise = make_builder();
+  for (size_t row = 0; row < is.size(); ++row) {
+    auto c = valid[row] ? data_view{cs[row]} : data_view{caf::none};
+    CHECK(rowwise->add(data_view{is[row]}, c, data_view{ss[row]},
+                       data_view{as[row]}));
+  }
+  CHECK_EQUAL(*columnar->finish(), *rowwise->finish());
+  MESSAGE("reject columns out of order, of the wrong type, or size");
+  CHECK(!columnar->append_integers(1, is));
+  CHECK(!columnar->append_counts(0, cs));
+  CHECK(columnar->append_integers(0, is));
+  CHECK(!columnar->append_counts(1, span<const count>{cs.data(), 2}));
+  CHECK(columnar->append_integers(0, is));
+  CHECK(!columnar->append_counts(1, cs, span<const uint8_t>{valid.data(), 2}));
+  CHECK_EQUAL(columnar->rows(), 0u);
+}
+
 } // namespace fixtures